@@ -0,0 +1,93 @@
+#include "analysisworker.h"
+#include <algorithm>
+#include "engineplayer.h"
+#include "trace.h"
+
+namespace {
+
+const int MaxAnalysisDepth = 9;
+
+} // namespace
+
+AnalysisWorker::AnalysisWorker(GameLogic *logic, QObject *parent)
+    : QObject(parent), m_logic(logic), m_enabled(false), m_stop(false), m_token(0),
+      m_lastDepth(0)
+{
+    GameEngine::Config config;
+    config.name = "analysis";
+    config.hashSizeMb = 8;
+    m_engine.setConfig(config);
+
+    connect(m_logic, &GameLogic::boardChanged, this, &AnalysisWorker::onBoardChanged);
+}
+
+AnalysisWorker::~AnalysisWorker()
+{
+    cancel();
+}
+
+void AnalysisWorker::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    onBoardChanged();
+}
+
+void AnalysisWorker::cancel()
+{
+    TRACE_SCOPE("AnalysisWorker::cancel", "sync");
+    ++m_token;
+    m_stop.store(true);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_stop.store(false);
+}
+
+void AnalysisWorker::onBoardChanged()
+{
+    cancel();
+
+    if (m_logic->moveCount() == 0) {
+        m_engine.newGame();
+    }
+    // Прошлая глубина полезна, только если анализ шёл на предыдущей позиции
+    if (m_logic->moveCount() == 0 || !m_enabled) {
+        m_lastDepth = 0;
+    }
+    emit heatmapReady(QVector<int>(), 0);
+
+    if (!m_enabled || m_logic->gameState() != GameLogic::StatePlaying) {
+        return;
+    }
+
+    // Новая позиция - потомок предыдущей: записи глубины d - 1 для неё уже
+    // лежат в таблице, поэтому после быстрой глубины 1 продолжаем с d - 2
+    Position position = positionFromLogic(*m_logic);
+    int emptyCells = position.cellCount() - position.moveCount();
+    int maxDepth = std::min(MaxAnalysisDepth, emptyCells);
+    int resumeDepth = std::max(2, m_lastDepth - 2);
+    m_lastDepth = 0;
+    quint64 token = m_token;
+
+    m_thread = std::thread([this, position, maxDepth, resumeDepth, token]() {
+        Trace::setThreadName("analysis");
+        std::vector<int> scores;
+        for (int depth = 1; depth <= maxDepth; depth = depth == 1 ? resumeDepth : depth + 1) {
+            if (!m_engine.analyse(position, depth, scores, &m_stop)) break;
+            m_lastDepth = depth;
+
+            QVector<int> values(int(scores.size()));
+            std::copy(scores.begin(), scores.end(), values.begin());
+            QMetaObject::invokeMethod(this, [this, token, values, depth]() {
+                publish(token, values, depth);
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+void AnalysisWorker::publish(quint64 token, const QVector<int> &scores, int depth)
+{
+    if (token != m_token) return;
+
+    emit heatmapReady(scores, depth);
+}
@@ -0,0 +1,48 @@
+#ifndef ANALYSISWORKER_H
+#define ANALYSISWORKER_H
+
+#include <QObject>
+#include <QVector>
+#include <atomic>
+#include <thread>
+#include "gameengine.h"
+#include "gamelogic.h"
+
+// Фоновый анализ позиции: оценивает все свободные клетки с постепенно
+// растущей глубиной и публикует результат после каждой итерации. При смене
+// позиции прежняя карта сразу сбрасывается; сначала публикуется глубина 1,
+// затем анализ продолжается с глубины, достигнутой на прошлой позиции, - 2.
+class AnalysisWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AnalysisWorker(GameLogic *logic, QObject *parent = nullptr);
+    ~AnalysisWorker() override;
+
+    bool isEnabled() const { return m_enabled; }
+
+public slots:
+    void setEnabled(bool enabled);
+
+signals:
+    void heatmapReady(const QVector<int> &scores, int depth);
+
+private slots:
+    void onBoardChanged();
+
+private:
+    void cancel();
+    void publish(quint64 token, const QVector<int> &scores, int depth);
+
+    GameLogic *m_logic;
+    GameEngine m_engine;
+    bool m_enabled;
+
+    std::thread m_thread;
+    std::atomic<bool> m_stop;
+    quint64 m_token;
+    int m_lastDepth; // пишет поток анализа, читается после cancel()
+};
+
+#endif // ANALYSISWORKER_H
@@ -0,0 +1,145 @@
+#include "engineplayer.h"
+#include <QVector>
+#include "openingbook.h"
+#include "trace.h"
+
+Position positionFromLogic(const GameLogic &logic)
+{
+    int size = logic.boardSize();
+    QVector<int> xCells;
+    QVector<int> oCells;
+
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            GameLogic::CellState cell = logic.cellState(row, col);
+            if (cell == GameLogic::CellX) xCells.append(row * size + col);
+            else if (cell == GameLogic::CellO) oCells.append(row * size + col);
+        }
+    }
+
+    // Хеш зависит только от расположения фишек, поэтому порядок не важен
+    Position position(size);
+    for (int i = 0; i < xCells.size(); ++i) {
+        position.play(xCells[i]);
+        if (i < oCells.size()) position.play(oCells[i]);
+    }
+    return position;
+}
+
+EnginePlayer::EnginePlayer(GameLogic *logic, QObject *parent)
+    : QObject(parent), m_logic(logic), m_side(GameLogic::PlayerNone),
+      m_ponderEnabled(true), m_stop(false), m_token(0)
+{
+    m_engine.setConfig(defaultConfig());
+    m_engine.setBook(&OpeningBook::defaultBook());
+
+    connect(m_logic, &GameLogic::boardChanged, this, &EnginePlayer::onBoardChanged);
+}
+
+EnginePlayer::~EnginePlayer()
+{
+    cancel();
+}
+
+GameEngine::Config EnginePlayer::defaultConfig()
+{
+    GameEngine::Config config;
+    config.name = "gui";
+    config.maxDepth = 6;
+    config.timeLimitMs = 1500;
+    return config;
+}
+
+void EnginePlayer::setSide(GameLogic::Player side)
+{
+    cancel();
+    m_side = side;
+    onBoardChanged();
+}
+
+void EnginePlayer::setPondering(bool enabled)
+{
+    cancel();
+    m_ponderEnabled = enabled;
+    onBoardChanged();
+}
+
+void EnginePlayer::setConfig(const GameEngine::Config &config)
+{
+    cancel();
+    m_engine.setConfig(config);
+    onBoardChanged();
+}
+
+void EnginePlayer::cancel()
+{
+    // Ожидание остановки потока поиска - потенциальная пауза GUI
+    TRACE_SCOPE("EnginePlayer::cancel", "sync");
+    ++m_token;
+    m_stop.store(true);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_stop.store(false);
+}
+
+void EnginePlayer::onBoardChanged()
+{
+    cancel();
+
+    if (m_logic->moveCount() == 0) {
+        m_engine.newGame();
+    }
+
+    if (m_side == GameLogic::PlayerNone || m_logic->gameState() != GameLogic::StatePlaying) {
+        return;
+    }
+
+    if (m_logic->currentPlayer() == m_side) {
+        startSearch();
+    } else if (m_ponderEnabled) {
+        startPonder();
+    }
+}
+
+void EnginePlayer::startSearch()
+{
+    Position position = positionFromLogic(*m_logic);
+    quint64 token = m_token;
+    m_turnTimer.start();
+
+    m_thread = std::thread([this, position, token]() {
+        Trace::setThreadName("engine search");
+        GameEngine::SearchResult result = m_engine.search(position, &m_stop);
+        QMetaObject::invokeMethod(this, [this, token, result]() {
+            applyMove(token, result.move);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void EnginePlayer::startPonder()
+{
+    Position position = positionFromLogic(*m_logic);
+
+    m_thread = std::thread([this, position]() {
+        Trace::setThreadName("engine ponder");
+        m_engine.ponder(position, &m_stop);
+    });
+}
+
+void EnginePlayer::applyMove(quint64 token, int move)
+{
+    TRACE_SCOPE("EnginePlayer::applyMove", "engine");
+
+    // Позиция могла измениться, пока шёл поиск
+    if (token != m_token || move < 0) return;
+
+    int size = m_logic->boardSize();
+    int row = move / size;
+    int col = move % size;
+    if (!m_logic->isValidMove(row, col) || m_logic->currentPlayer() != m_side) return;
+
+    qint64 latency = m_turnTimer.elapsed();
+    m_logic->makeMove(row, col);
+    emit moveMade(row, col, latency);
+}
@@ -0,0 +1,54 @@
+#ifndef ENGINEPLAYER_H
+#define ENGINEPLAYER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <atomic>
+#include <thread>
+#include "gameengine.h"
+#include "gamelogic.h"
+
+Position positionFromLogic(const GameLogic &logic);
+
+// Компьютерный игрок: ищет ход в отдельном потоке, а пока ходит
+// соперник - обдумывает позицию заранее (pondering)
+class EnginePlayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EnginePlayer(GameLogic *logic, QObject *parent = nullptr);
+    ~EnginePlayer() override;
+
+    GameLogic::Player side() const { return m_side; }
+    void setSide(GameLogic::Player side);
+    bool isPondering() const { return m_ponderEnabled; }
+    void setPondering(bool enabled);
+    void setConfig(const GameEngine::Config &config);
+
+    static GameEngine::Config defaultConfig();
+
+signals:
+    void moveMade(int row, int col, qint64 latencyMs);
+
+private slots:
+    void onBoardChanged();
+
+private:
+    void cancel();
+    void startSearch();
+    void startPonder();
+    void applyMove(quint64 token, int move);
+
+    GameLogic *m_logic;
+    GameEngine m_engine;
+    GameLogic::Player m_side;
+    bool m_ponderEnabled;
+
+    std::thread m_thread;
+    std::atomic<bool> m_stop;
+    quint64 m_token;
+    QElapsedTimer m_turnTimer;
+};
+
+#endif // ENGINEPLAYER_H
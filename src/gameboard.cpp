@@ -2,19 +2,29 @@
 #include <QPainter>
 #include <QMouseEvent>
 #include <QDebug>
+#include <cmath>
+#include "gameengine.h"
+#include "metrics.h"
+#include "trace.h"
 
 GameBoard::GameBoard(QWidget *parent)
-    : QWidget(parent), gameLogic(nullptr)
+    : QWidget(parent), gameLogic(nullptr), interactive(true), heatmapVisible(false),
+      heatmapTimer(new QTimer(this))
 {
     setMinimumSize(240, 240);
-    setStyleSheet("background-color: #1e1e1e;");
+
+    // Обновления анализа перерисовываем не чаще 10 раз в секунду
+    heatmapTimer->setSingleShot(true);
+    heatmapTimer->setInterval(100);
+    connect(heatmapTimer, &QTimer::timeout, this, QOverload<>::of(&GameBoard::update));
 }
 
 void GameBoard::setGameLogic(GameLogic *logic)
 {
     gameLogic = logic;
-    connect(gameLogic, &GameLogic::boardChanged, this, QOverload<>::of(&GameBoard::update));
     if (gameLogic) {
+        connect(gameLogic, &GameLogic::boardChanged, this, &GameBoard::onBoardChanged);
+        connect(gameLogic, &GameLogic::gameFinished, this, &GameBoard::onBoardChanged);
         connect(gameLogic, &GameLogic::boardSizeChanged, this, &GameBoard::updateSize);
     }
 }
@@ -34,6 +44,28 @@ void GameBoard::updateSize()
     update();
 }
 
+void GameBoard::onBoardChanged()
+{
+    // Оценки прежней позиции даны с точки зрения другой стороны - до
+    // первой итерации анализа новой позиции клетки не закрашиваем
+    heatmap.clear();
+    update();
+}
+
+void GameBoard::setHeatmap(const QVector<int> &scores)
+{
+    heatmap = scores;
+    if (heatmapVisible && !heatmapTimer->isActive()) {
+        heatmapTimer->start();
+    }
+}
+
+void GameBoard::setHeatmapVisible(bool visible)
+{
+    heatmapVisible = visible;
+    update();
+}
+
 int GameBoard::cellSize() const
 {
     if (!gameLogic) return 80;
@@ -52,6 +84,10 @@ void GameBoard::paintEvent(QPaintEvent *event)
 
     if (!gameLogic) return;
 
+    TRACE_SCOPE("GameBoard::paintEvent", "paint");
+    Metrics::ScopedTimer timer(Metrics::PaintNs);
+    Metrics::add(Metrics::Frames);
+
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
 
@@ -63,6 +99,8 @@ void GameBoard::paintEvent(QPaintEvent *event)
 
     drawGrid(painter);
     drawSymbols(painter);
+
+    emit framePainted();
 }
 
 void GameBoard::drawGrid(QPainter &painter)
@@ -87,13 +125,24 @@ void GameBoard::drawSymbols(QPainter &painter)
 {
     int size = gameLogic->boardSize();
     int cellSizeValue = cellSize();
+    bool showHeatmap = heatmapVisible && heatmap.size() == size * size
+                       && gameLogic->gameState() == GameLogic::StatePlaying;
 
     for (int row = 0; row < size; ++row) {
         for (int col = 0; col < size; ++col) {
             GameLogic::CellState cell = gameLogic->cellState(row, col);
             QRect rect = cellRect(row, col);
 
-            if (cell == GameLogic::CellX) {
+            if (cell == GameLogic::CellEmpty && showHeatmap) {
+                // Оценка хода для того, чья очередь: зелёный - хорошо, красный - плохо
+                int score = heatmap[row * size + col];
+                double value = score >= GameEngine::MateThreshold ? 1.0
+                             : score <= -GameEngine::MateThreshold ? -1.0
+                             : std::tanh(score / 100.0);
+                QColor color = value >= 0 ? QColor("#2ed573") : QColor("#ff4757");
+                color.setAlphaF(0.6 * qAbs(value));
+                painter.fillRect(rect.adjusted(3, 3, -2, -2), color);
+            } else if (cell == GameLogic::CellX) {
                 // X с градиентом
                 QLinearGradient xGradient(rect.topLeft(), rect.bottomRight());
                 xGradient.setColorAt(0, QColor("#ff6b6b"));
@@ -137,7 +186,7 @@ QPoint GameBoard::cellAtPosition(const QPoint &pos) const
 
 void GameBoard::mousePressEvent(QMouseEvent *event)
 {
-    if (!gameLogic || gameLogic->gameState() != GameLogic::StatePlaying) {
+    if (!gameLogic || !interactive || gameLogic->gameState() != GameLogic::StatePlaying) {
         return;
     }
 
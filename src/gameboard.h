@@ -2,6 +2,8 @@
 #define GAMEBOARD_H
 
 #include <QWidget>
+#include <QTimer>
+#include <QVector>
 #include "gamelogic.h"
 
 class GameBoard : public QWidget
@@ -11,15 +13,25 @@ class GameBoard : public QWidget
 public:
     explicit GameBoard(QWidget *parent = nullptr);
     void setGameLogic(GameLogic *logic);
+    void setInteractive(bool interactive) { this->interactive = interactive; }
+    bool hasHeatmap() const { return !heatmap.isEmpty(); }
     QSize sizeHint() const override;
 
+signals:
+    void framePainted();
+
 public slots:
     void updateSize();
+    void setHeatmap(const QVector<int> &scores);
+    void setHeatmapVisible(bool visible);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
 
+private slots:
+    void onBoardChanged();
+
 private:
     void drawGrid(QPainter &painter);
     void drawSymbols(QPainter &painter);
@@ -28,6 +40,11 @@ private:
     int cellSize() const;
 
     GameLogic *gameLogic;
+    bool interactive;
+
+    QVector<int> heatmap;
+    bool heatmapVisible;
+    QTimer *heatmapTimer;
 };
 
 #endif // GAMEBOARD_H
@@ -0,0 +1,508 @@
+#include "gameengine.h"
+#include <algorithm>
+#include <chrono>
+#include "metrics.h"
+#include "openingbook.h"
+#include "trace.h"
+
+namespace {
+
+struct ZobristKeys
+{
+    std::uint64_t cells[Position::MaxSize * Position::MaxSize][2];
+    std::uint64_t side;
+    std::uint64_t size[Position::MaxSize + 1];
+
+    ZobristKeys()
+    {
+        std::uint64_t state = 0x9e3779b97f4a7c15ULL;
+        auto next = [&state]() {
+            std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        };
+
+        for (auto &cell : cells) {
+            cell[0] = next();
+            cell[1] = next();
+        }
+        side = next();
+        for (auto &key : size) {
+            key = next();
+        }
+    }
+};
+
+const ZobristKeys &zobrist()
+{
+    static const ZobristKeys keys;
+    return keys;
+}
+
+std::int64_t nowMs()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+const int LineWeight[Position::MaxSize + 1] = {
+    0, 1, 8, 27, 64, 125, 216, 343, 512, 729, 1000
+};
+
+} // namespace
+
+Position::Position(int size)
+{
+    reset(size);
+}
+
+void Position::reset(int size)
+{
+    m_size = std::min(std::max(size, int(MinSize)), int(MaxSize));
+    m_sideToMove = 1;
+    m_moveCount = 0;
+    m_winner = 0;
+    m_deadLines = 0;
+    m_hash = zobrist().size[m_size];
+    m_cells.assign(cellCount(), 0);
+    m_lineStones.assign(lineCount() * 2, 0);
+}
+
+int Position::linesThrough(int index, int *lines) const
+{
+    int row = index / m_size;
+    int col = index % m_size;
+    int count = 0;
+
+    lines[count++] = row;
+    lines[count++] = m_size + col;
+    if (row == col) lines[count++] = 2 * m_size;
+    if (row + col == m_size - 1) lines[count++] = 2 * m_size + 1;
+
+    return count;
+}
+
+int Position::transform(int size, int symmetry, int index)
+{
+    int n = size - 1;
+    int row = index / size;
+    int col = index % size;
+
+    switch (symmetry) {
+    case 1: return col * size + (n - row);
+    case 2: return (n - row) * size + (n - col);
+    case 3: return (n - col) * size + row;
+    case 4: return row * size + (n - col);
+    case 5: return (n - row) * size + col;
+    case 6: return col * size + row;
+    case 7: return (n - col) * size + (n - row);
+    default: return index;
+    }
+}
+
+std::uint64_t Position::symmetryHash(int symmetry) const
+{
+    if (symmetry == 0) return m_hash;
+
+    std::uint64_t hash = zobrist().size[m_size] ^ ((m_moveCount & 1) ? zobrist().side : 0);
+    for (int index = 0; index < cellCount(); ++index) {
+        if (m_cells[index] != 0) {
+            hash ^= zobrist().cells[transform(m_size, symmetry, index)][m_cells[index] - 1];
+        }
+    }
+    return hash;
+}
+
+std::uint64_t Position::canonicalHash(int *symmetry) const
+{
+    std::uint64_t best = m_hash;
+    int bestSymmetry = 0;
+
+    for (int s = 1; s < SymmetryCount; ++s) {
+        std::uint64_t hash = symmetryHash(s);
+        if (hash < best) {
+            best = hash;
+            bestSymmetry = s;
+        }
+    }
+
+    if (symmetry) *symmetry = bestSymmetry;
+    return best;
+}
+
+int Position::canonicalMove(int index) const
+{
+    std::uint64_t hashes[SymmetryCount];
+    std::uint64_t best = m_hash;
+    for (int s = 0; s < SymmetryCount; ++s) {
+        hashes[s] = symmetryHash(s);
+        best = std::min(best, hashes[s]);
+    }
+
+    int move = cellCount();
+    for (int s = 0; s < SymmetryCount; ++s) {
+        if (hashes[s] == best) move = std::min(move, transform(m_size, s, index));
+    }
+    return move;
+}
+
+void Position::play(int index)
+{
+    int player = m_sideToMove;
+    int lines[4];
+    int count = linesThrough(index, lines);
+
+    for (int i = 0; i < count; ++i) {
+        std::uint8_t &own = m_lineStones[lines[i] * 2 + player - 1];
+        std::uint8_t opponent = m_lineStones[lines[i] * 2 + (2 - player)];
+        if (own == 0 && opponent > 0) ++m_deadLines;
+        if (++own == m_size) m_winner = player;
+    }
+
+    m_cells[index] = std::uint8_t(player);
+    m_hash ^= zobrist().cells[index][player - 1] ^ zobrist().side;
+    m_sideToMove = 3 - player;
+    ++m_moveCount;
+}
+
+void Position::undo(int index)
+{
+    int player = m_cells[index];
+    int lines[4];
+    int count = linesThrough(index, lines);
+
+    for (int i = 0; i < count; ++i) {
+        std::uint8_t &own = m_lineStones[lines[i] * 2 + player - 1];
+        std::uint8_t opponent = m_lineStones[lines[i] * 2 + (2 - player)];
+        if (--own == 0 && opponent > 0) --m_deadLines;
+    }
+
+    m_cells[index] = 0;
+    m_hash ^= zobrist().cells[index][player - 1] ^ zobrist().side;
+    m_sideToMove = player;
+    m_winner = 0;
+    --m_moveCount;
+}
+
+GameEngine::GameEngine()
+    : GameEngine(Config())
+{
+}
+
+GameEngine::GameEngine(const Config &config)
+    : m_book(nullptr), m_tableMask(0), m_generation(0), m_stopFlag(nullptr), m_stopped(false),
+      m_nodes(0), m_nodeLimit(0), m_deadline(0)
+{
+    setConfig(config);
+}
+
+void GameEngine::setConfig(const Config &config)
+{
+    m_config = config;
+
+    std::size_t entries = 1;
+    std::size_t budget = std::size_t(std::max(config.hashSizeMb, 1)) * 1024 * 1024 / sizeof(Entry);
+    while (entries * 2 <= budget) {
+        entries *= 2;
+    }
+
+    // Таблица выделяется при первом переборе: движки создаются при запуске
+    // GUI, а до первого хода память им не нужна
+    std::vector<Entry>().swap(m_table);
+    m_tableMask = entries - 1;
+}
+
+void GameEngine::allocateTable()
+{
+    if (m_table.empty()) {
+        m_table.assign(m_tableMask + 1, Entry());
+    }
+}
+
+void GameEngine::newGame()
+{
+    std::fill(m_table.begin(), m_table.end(), Entry());
+    m_generation = 0;
+}
+
+int GameEngine::evaluate(const Position &position)
+{
+    int side = position.sideToMove();
+    int score = 0;
+
+    for (int line = 0; line < position.lineCount(); ++line) {
+        int own = position.lineStones(line, side);
+        int opponent = position.lineStones(line, 3 - side);
+        if (opponent == 0) score += LineWeight[own];
+        if (own == 0) score -= LineWeight[opponent];
+    }
+
+    return score;
+}
+
+GameEngine::SearchResult GameEngine::search(const Position &position, const std::atomic<bool> *stop)
+{
+    return iterate(position, stop, true, m_config.maxDepth);
+}
+
+GameEngine::SearchResult GameEngine::ponder(const Position &position, const std::atomic<bool> *stop)
+{
+    // Неглубокий перебор за соперника предсказывает его ответ, затем позиция
+    // после этого ответа перебирается на полную глубину. При угадывании
+    // search() получает точные записи таблицы для всех своих итераций.
+    SearchResult guess = iterate(position, stop, false, std::max(1, m_config.maxDepth - 2));
+    if (guess.move < 0 || (stop && stop->load())) return guess;
+
+    Position predicted = position;
+    predicted.play(guess.move);
+    if (predicted.winner() != 0 || predicted.isFull()) return guess;
+
+    SearchResult result = iterate(predicted, stop, false, m_config.maxDepth);
+    result.nodes += guess.nodes;
+    result.move = guess.move;
+    return result;
+}
+
+bool GameEngine::analyse(const Position &position, int depth, std::vector<int> &scores,
+                         const std::atomic<bool> *stop)
+{
+    Trace::Scope scope("GameEngine::analyse", "engine", "depth", depth);
+
+    m_stopFlag = stop;
+    m_stopped = false;
+    m_nodes = 0;
+    m_nodeLimit = 0;
+    m_deadline = 0;
+    ++m_generation;
+    allocateTable();
+
+    Position work = position;
+    scores.assign(work.cellCount(), 0);
+
+    for (int index = 0; index < work.cellCount() && !m_stopped; ++index) {
+        if (work.cell(index) != 0 || work.winner() != 0) continue;
+
+        work.play(index);
+        scores[index] = -negamax(work, depth - 1, -WinScore - 1, WinScore + 1, 1);
+        work.undo(index);
+    }
+
+    m_stopFlag = nullptr;
+    return !m_stopped;
+}
+
+GameEngine::SearchResult GameEngine::iterate(const Position &position, const std::atomic<bool> *stop,
+                                             bool limited, int depthLimit)
+{
+    SearchResult result;
+    std::int64_t start = nowMs();
+    std::uint64_t startNs = Metrics::enabled() ? Metrics::nowNs() : 0;
+    TRACE_SCOPE(limited ? "GameEngine::search" : "GameEngine::ponder", "engine");
+
+    m_stopFlag = stop;
+    m_stopped = false;
+    m_nodes = 0;
+    m_nodeLimit = limited ? m_config.nodeLimit : 0;
+    m_deadline = limited && m_config.timeLimitMs > 0 ? start + m_config.timeLimitMs : 0;
+    ++m_generation;
+
+    // В безнадёжно ничейной позиции ход всё равно нужен, пока поле не заполнено
+    if (position.winner() != 0 || position.isFull()) {
+        return result;
+    }
+
+    if (limited && m_book) {
+        int move = m_book->probe(position);
+        if (move >= 0) {
+            result.move = move;
+            result.elapsedMs = nowMs() - start;
+            m_stopFlag = nullptr;
+            return result;
+        }
+    }
+
+    allocateTable();
+    Position work = position;
+    int moves[Position::MaxSize * Position::MaxSize];
+    int emptyCells = work.cellCount() - work.moveCount();
+    int maxDepth = std::min(depthLimit, emptyCells);
+
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        if (depth > 1 && shouldStop()) break;
+
+        Trace::Scope iteration("iteration", "engine", "depth", depth);
+
+        const Entry *entry = probe(work.hash());
+        int count = orderMoves(work, entry ? entry->move : -1, moves);
+
+        int alpha = -WinScore - 1;
+        int bestMove = -1;
+
+        for (int i = 0; i < count; ++i) {
+            work.play(moves[i]);
+            int score = -negamax(work, depth - 1, -WinScore - 1, -alpha, 1);
+            work.undo(moves[i]);
+
+            if (m_stopped) break;
+
+            if (score > alpha) {
+                alpha = score;
+                bestMove = moves[i];
+            }
+        }
+
+        // Незавершённую итерацию используем, только если ещё нет ни одного хода
+        if (m_stopped && result.move >= 0) break;
+        if (bestMove < 0) bestMove = moves[0];
+
+        result.move = bestMove;
+        result.score = alpha;
+        result.depth = depth;
+        store(work.hash(), alpha, depth, BoundExact, bestMove, 0);
+
+        if (m_stopped || alpha >= MateThreshold || alpha <= -MateThreshold) break;
+    }
+
+    result.nodes = m_nodes;
+    result.elapsedMs = nowMs() - start;
+    m_stopFlag = nullptr;
+
+    if (limited && startNs != 0) {
+        std::uint64_t elapsedNs = Metrics::nowNs() - startNs;
+        Metrics::add(Metrics::Searches);
+        Metrics::add(Metrics::SearchNodes, result.nodes);
+        Metrics::record(Metrics::SearchNs, elapsedNs);
+        Metrics::record(Metrics::SearchDepth, std::uint64_t(result.depth));
+        if (elapsedNs > 0) {
+            Metrics::record(Metrics::SearchNodesPerSecond, result.nodes * 1000000000ULL / elapsedNs);
+        }
+    }
+    return result;
+}
+
+int GameEngine::negamax(Position &position, int depth, int alpha, int beta, int ply)
+{
+    if (position.winner() != 0) return -(WinScore - ply);
+    if (position.isDrawn() || position.isFull()) return 0;
+    if (depth <= 0) return evaluate(position);
+
+    if ((++m_nodes & 1023) == 0 && shouldStop()) return 0;
+    if (m_stopped) return 0;
+
+    int originalAlpha = alpha;
+    int ttMove = -1;
+    if (const Entry *entry = probe(position.hash())) {
+        ttMove = entry->move;
+        if (entry->depth >= depth) {
+            int score = entry->score;
+            if (score >= MateThreshold) score -= ply;
+            else if (score <= -MateThreshold) score += ply;
+
+            if (entry->bound == BoundExact) return score;
+            if (entry->bound == BoundLower && score >= beta) return score;
+            if (entry->bound == BoundUpper && score <= alpha) return score;
+        }
+    }
+
+    int moves[Position::MaxSize * Position::MaxSize];
+    int count = orderMoves(position, ttMove, moves);
+    int bestScore = -WinScore - 1;
+    int bestMove = moves[0];
+
+    for (int i = 0; i < count; ++i) {
+        position.play(moves[i]);
+        int score = -negamax(position, depth - 1, -beta, -alpha, ply + 1);
+        position.undo(moves[i]);
+
+        if (m_stopped) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = moves[i];
+        }
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) break;
+    }
+
+    Bound bound = bestScore <= originalAlpha ? BoundUpper
+                : bestScore >= beta ? BoundLower : BoundExact;
+    store(position.hash(), bestScore, depth, bound, bestMove, ply);
+    return bestScore;
+}
+
+int GameEngine::orderMoves(const Position &position, int ttMove, int *moves) const
+{
+    int scores[Position::MaxSize * Position::MaxSize];
+    int side = position.sideToMove();
+    int size = position.size();
+    int count = 0;
+
+    for (int index = 0; index < position.cellCount(); ++index) {
+        if (position.cell(index) != 0) continue;
+
+        int row = index / size;
+        int col = index % size;
+        int lines[4] = { row, size + col, -1, -1 };
+        if (row == col) lines[2] = 2 * size;
+        if (row + col == size - 1) lines[3] = 2 * size + 1;
+
+        int score = 0;
+        for (int line : lines) {
+            if (line < 0) continue;
+            int own = position.lineStones(line, side);
+            int opponent = position.lineStones(line, 3 - side);
+            if (opponent == 0) score += own == size - 1 ? 1000000 : (own + 1) * (own + 1);
+            if (own == 0) score += opponent == size - 1 ? 100000 : (opponent + 1) * (opponent + 1);
+        }
+        if (index == ttMove) score = 10000000;
+
+        int i = count++;
+        while (i > 0 && scores[i - 1] < score) {
+            scores[i] = scores[i - 1];
+            moves[i] = moves[i - 1];
+            --i;
+        }
+        scores[i] = score;
+        moves[i] = index;
+    }
+
+    return count;
+}
+
+bool GameEngine::shouldStop()
+{
+    if ((m_stopFlag && m_stopFlag->load(std::memory_order_relaxed))
+        || (m_deadline > 0 && nowMs() >= m_deadline)
+        || (m_nodeLimit > 0 && m_nodes >= m_nodeLimit)) {
+        m_stopped = true;
+    }
+    return m_stopped;
+}
+
+const GameEngine::Entry *GameEngine::probe(std::uint64_t key) const
+{
+    const Entry &entry = m_table[key & m_tableMask];
+    return entry.bound != BoundNone && entry.key == key ? &entry : nullptr;
+}
+
+void GameEngine::store(std::uint64_t key, int score, int depth, Bound bound, int move, int ply)
+{
+    // Записи прошлых поисков (в том числе обдумывания чужих веток)
+    // вытесняются безусловно, текущего - только более глубокими
+    Entry &entry = m_table[key & m_tableMask];
+    if (entry.bound != BoundNone && entry.key != key
+        && entry.generation == m_generation && entry.depth > depth) {
+        return;
+    }
+
+    if (score >= MateThreshold) score += ply;
+    else if (score <= -MateThreshold) score -= ply;
+
+    entry.key = key;
+    entry.score = score;
+    entry.depth = std::int8_t(std::min(depth, 127));
+    entry.bound = bound;
+    entry.move = std::int8_t(move);
+    entry.generation = m_generation;
+}
@@ -0,0 +1,150 @@
+#ifndef GAMEENGINE_H
+#define GAMEENGINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Компактная позиция для перебора: клетки 0 - пусто, 1 - X, 2 - O
+// (совпадает с GameLogic::CellState), счётчики фишек по линиям
+// поддерживаются инкрементально, хеш - Zobrist.
+class Position
+{
+public:
+    enum { MinSize = 3, MaxSize = 10, SymmetryCount = 8 };
+
+    explicit Position(int size = 3);
+
+    void reset(int size);
+    void play(int index);
+    void undo(int index);
+
+    int size() const { return m_size; }
+    int cellCount() const { return m_size * m_size; }
+    int cell(int index) const { return m_cells[index]; }
+    int cell(int row, int col) const { return m_cells[row * m_size + col]; }
+    int sideToMove() const { return m_sideToMove; }
+    int moveCount() const { return m_moveCount; }
+    int winner() const { return m_winner; }
+    std::uint64_t hash() const { return m_hash; }
+
+    int lineCount() const { return 2 * m_size + 2; }
+    int lineStones(int line, int player) const { return m_lineStones[line * 2 + player - 1]; }
+
+    // Все линии заблокированы обеими сторонами - победить уже невозможно
+    bool isDrawn() const { return m_winner == 0 && m_deadLines == lineCount(); }
+    bool isFull() const { return m_moveCount == cellCount(); }
+    bool isFinished() const { return m_winner != 0 || isDrawn() || isFull(); }
+
+    // Образ клетки при одной из 8 симметрий квадрата
+    static int transform(int size, int symmetry, int index);
+    // Наименьший хеш среди симметричных вариантов позиции
+    std::uint64_t canonicalHash(int *symmetry = nullptr) const;
+    // Образ хода в канонической ориентации. Если позиция симметрична,
+    // равноценные ходы сводятся к одному - наименьшему образу
+    int canonicalMove(int index) const;
+
+private:
+    std::uint64_t symmetryHash(int symmetry) const;
+    int linesThrough(int index, int *lines) const;
+
+    int m_size;
+    int m_sideToMove;
+    int m_moveCount;
+    int m_winner;
+    int m_deadLines;
+    std::uint64_t m_hash;
+    std::vector<std::uint8_t> m_cells;
+    std::vector<std::uint8_t> m_lineStones;
+};
+
+class OpeningBook;
+
+class GameEngine
+{
+public:
+    enum { WinScore = 1000000, MateThreshold = WinScore - 1000 };
+
+    struct Config
+    {
+        std::string name = "engine";
+        int maxDepth = 64;
+        int timeLimitMs = 1000;      // 0 - без ограничения
+        std::uint64_t nodeLimit = 0; // 0 - без ограничения
+        int hashSizeMb = 16;
+    };
+
+    struct SearchResult
+    {
+        int move = -1;
+        int score = 0;
+        int depth = 0;
+        std::uint64_t nodes = 0;
+        std::int64_t elapsedMs = 0;
+    };
+
+    GameEngine();
+    explicit GameEngine(const Config &config);
+
+    const Config &config() const { return m_config; }
+    void setConfig(const Config &config);
+
+    // Очистка таблицы транспозиций между партиями
+    void newGame();
+
+    // Дебютная книга проверяется перед каждым search(), но не ponder()
+    void setBook(const OpeningBook *book) { m_book = book; }
+
+    SearchResult search(const Position &position, const std::atomic<bool> *stop = nullptr);
+
+    // Обдумывание в позиции, где ходит соперник, без ограничения по времени:
+    // предсказывает его ответ (возвращается в move) и перебирает позицию
+    // после него на полную глубину. Если соперник ответил так, как
+    // предсказано, следующий search() почти целиком берётся из таблицы.
+    SearchResult ponder(const Position &position, const std::atomic<bool> *stop);
+
+    // Оценка каждого свободного поля перебором на заданную глубину с точки
+    // зрения стороны, которая ходит. Возвращает false, если перебор прерван.
+    bool analyse(const Position &position, int depth, std::vector<int> &scores,
+                 const std::atomic<bool> *stop);
+
+    static int evaluate(const Position &position);
+
+private:
+    struct Entry
+    {
+        std::uint64_t key;
+        std::int32_t score;
+        std::int8_t depth;
+        std::uint8_t bound;
+        std::int8_t move;
+        std::uint8_t generation;
+    };
+
+    enum Bound : std::uint8_t { BoundNone, BoundExact, BoundLower, BoundUpper };
+
+    SearchResult iterate(const Position &position, const std::atomic<bool> *stop, bool limited,
+                         int depthLimit);
+    int negamax(Position &position, int depth, int alpha, int beta, int ply);
+    int orderMoves(const Position &position, int ttMove, int *moves) const;
+    bool shouldStop();
+    void allocateTable();
+
+    const Entry *probe(std::uint64_t key) const;
+    void store(std::uint64_t key, int score, int depth, Bound bound, int move, int ply);
+
+    Config m_config;
+    const OpeningBook *m_book;
+    std::vector<Entry> m_table;
+    std::uint64_t m_tableMask;
+    std::uint8_t m_generation;
+
+    const std::atomic<bool> *m_stopFlag;
+    bool m_stopped;
+    std::uint64_t m_nodes;
+    std::uint64_t m_nodeLimit;
+    std::int64_t m_deadline;
+};
+
+#endif // GAMEENGINE_H
@@ -1,5 +1,7 @@
 #include "gamelogic.h"
 #include <QDebug>
+#include "metrics.h"
+#include "trace.h"
 
 GameLogic::GameLogic(QObject *parent)
     : QObject(parent), m_currentPlayer(PlayerX), m_gameState(StatePlaying),
@@ -10,6 +12,8 @@ GameLogic::GameLogic(QObject *parent)
 
 void GameLogic::newGame()
 {
+    TRACE_SCOPE("GameLogic::newGame", "logic");
+
     m_board.resize(m_boardSize);
     for (int i = 0; i < m_boardSize; ++i) {
         m_board[i].resize(m_boardSize);
@@ -32,13 +36,21 @@ void GameLogic::makeMove(int row, int col)
         return;
     }
 
+    TRACE_SCOPE("GameLogic::makeMove", "logic");
+
+    // Время хода меряем без обработчиков сигналов (там бывают модальные диалоги)
+    Metrics::ScopedTimer timer(Metrics::MakeMoveNs);
     m_board[row][col] = (m_currentPlayer == PlayerX) ? CellX : CellO;
+    bool won = checkWin(m_currentPlayer);
+    bool drawn = !won && checkDraw();
+    timer.stop();
+    Metrics::add(Metrics::Moves);
 
-    if (checkWin(m_currentPlayer)) {
+    if (won) {
         m_gameState = StateFinished;
         m_winner = m_currentPlayer;
         emit gameFinished(m_winner);
-    } else if (checkDraw()) {
+    } else if (drawn) {
         m_gameState = StateFinished;
         m_winner = PlayerNone;
         emit gameFinished(m_winner);
@@ -97,6 +109,7 @@ void GameLogic::setBoardSize(int size)
 
 bool GameLogic::checkWin(Player player) const
 {
+    Metrics::ScopedTimer timer(Metrics::WinCheckNs);
     CellState target = (player == PlayerX) ? CellX : CellO;
 
     for (int i = 0; i < m_boardSize; ++i) {
@@ -124,6 +137,7 @@ bool GameLogic::checkWin(Player player) const
 
 bool GameLogic::checkDraw() const
 {
+    Metrics::ScopedTimer timer(Metrics::DrawCheckNs);
     for (int i = 0; i < m_boardSize; ++i) {
         for (int j = 0; j < m_boardSize; ++j) {
             if (m_board[i][j] == CellEmpty) {
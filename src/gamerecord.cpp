@@ -0,0 +1,35 @@
+#include "gamerecord.h"
+#include <sstream>
+#include <string>
+
+void writeGameRecord(std::ostream &out, const GameRecord &record)
+{
+    out << record.size << ' ' << record.result;
+    for (std::uint8_t move : record.moves) {
+        out << ' ' << int(move);
+    }
+    out << '\n';
+}
+
+bool readGameRecord(std::istream &in, GameRecord &record)
+{
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        if (!(fields >> record.size >> record.result)) continue;
+        if (record.size < 3 || record.size > 10 || record.result < 0 || record.result > 2) continue;
+
+        record.moves.clear();
+        int move;
+        bool valid = true;
+        while (fields >> move) {
+            if (move < 0 || move >= record.size * record.size) {
+                valid = false;
+                break;
+            }
+            record.moves.push_back(std::uint8_t(move));
+        }
+        if (valid) return true;
+    }
+    return false;
+}
@@ -0,0 +1,21 @@
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+// Запись партии одной строкой: "<размер> <результат> <ход> <ход> ...",
+// результат: 0 - ничья, 1 - победа X, 2 - победа O; ход - индекс клетки
+struct GameRecord
+{
+    int size = 3;
+    int result = 0;
+    std::vector<std::uint8_t> moves;
+};
+
+void writeGameRecord(std::ostream &out, const GameRecord &record);
+bool readGameRecord(std::istream &in, GameRecord &record);
+
+#endif // GAMERECORD_H
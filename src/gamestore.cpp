@@ -0,0 +1,496 @@
+#include "gamestore.h"
+#include <QDir>
+#include <QFile>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include "trace.h"
+
+using namespace GameStoreFormat;
+
+namespace {
+
+const char StoreMagic[8] = { 'T', 'T', 'T', 'S', 'T', 'O', 'R', '2' };
+
+struct StoreHeader
+{
+    char magic[8];
+    std::uint32_t blockRows;
+    std::uint32_t dictionaryPlies;
+    std::uint64_t games;
+    std::uint64_t moves;
+    std::uint64_t positions;
+    std::uint64_t indexRows;
+    std::uint64_t blocks;
+};
+
+static_assert(sizeof(StoreHeader) == 56, "store header layout is part of the file format");
+static_assert(sizeof(GameBlock) == 16, "game block layout is part of the file format");
+
+const char *const ColumnFiles[] = {
+    "games.size", "games.result", "games.length", "games.opening",
+    "moves.game", "moves.ply", "moves.cell", "moves.canonical", "moves.position",
+};
+
+enum { MaxCells = Position::MaxSize * Position::MaxSize, ReadRows = 1 << 16 };
+
+std::string filePath(const std::string &directory, const char *name)
+{
+    return directory + "/" + name;
+}
+
+template <typename T>
+void writeValues(std::ofstream &out, const std::vector<T> &values)
+{
+    out.write(reinterpret_cast<const char *>(values.data()), std::streamsize(values.size() * sizeof(T)));
+}
+
+template <typename T>
+bool readValues(std::ifstream &in, std::vector<T> &values, std::size_t count)
+{
+    values.resize(count);
+    in.read(reinterpret_cast<char *>(values.data()), std::streamsize(count * sizeof(T)));
+    return bool(in);
+}
+
+void countResult(GameStore::Outcomes &outcomes, int result)
+{
+    ++outcomes.games;
+    if (result == 1) ++outcomes.xWins;
+    else if (result == 2) ++outcomes.oWins;
+    else ++outcomes.draws;
+}
+
+void mergeOutcomes(GameStore::Outcomes &to, const GameStore::Outcomes &from)
+{
+    to.games += from.games;
+    to.xWins += from.xWins;
+    to.draws += from.draws;
+    to.oWins += from.oWins;
+}
+
+// Потоки разбирают блоки по одному через общий счётчик, у каждого свой
+// накопитель - объединение после завершения
+template <typename Local, typename Scan>
+std::vector<Local> parallelScan(std::size_t blocks, int threads, const Local &initial, Scan scan)
+{
+    std::vector<Local> locals(std::size_t(threads), initial);
+    std::atomic<std::size_t> next(0);
+
+    auto work = [&](int thread) {
+        for (std::size_t block = next.fetch_add(1); block < blocks; block = next.fetch_add(1)) {
+            scan(block, locals[std::size_t(thread)]);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int thread = 1; thread < threads; ++thread) {
+        pool.emplace_back(work, thread);
+    }
+    work(0);
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+    return locals;
+}
+
+} // namespace
+
+GameStoreWriter::GameStoreWriter(const std::string &directory, int dictionaryPlies, std::uint32_t blockRows)
+    : m_directory(directory), m_dictionaryPlies(std::max(dictionaryPlies, 0)),
+      m_blockRows(std::max<std::uint32_t>(blockRows, 1)), m_open(false), m_finished(false),
+      m_games(0), m_moves(0), m_written(0)
+{
+    if (!QDir().mkpath(QString::fromStdString(directory))) return;
+
+    // Метаданные пишутся последними: недописанное хранилище не откроется
+    QFile::remove(QString::fromStdString(filePath(directory, "store.meta")));
+
+    m_open = true;
+    for (int column = 0; column < ColumnCount; ++column) {
+        m_files[column].open(filePath(directory, ColumnFiles[column]), std::ios::binary | std::ios::trunc);
+        m_open = m_open && m_files[column].is_open();
+    }
+}
+
+GameStoreWriter::~GameStoreWriter()
+{
+    if (m_open && !m_finished) finish();
+}
+
+bool GameStoreWriter::add(const GameRecord &record)
+{
+    if (!m_open || m_finished) return false;
+    if (record.size < Position::MinSize || record.size > Position::MaxSize) return false;
+    if (record.moves.size() > std::size_t(record.size * record.size)) return false;
+
+    // Сначала проверяем партию целиком, чтобы не записать её наполовину
+    Position position(record.size);
+    std::uint64_t keys[MaxCells];
+    std::uint8_t canonical[MaxCells];
+    int plies = int(record.moves.size());
+
+    for (int ply = 0; ply < plies; ++ply) {
+        int move = record.moves[std::size_t(ply)];
+        // Конец партии - победа или полное поле: ничья может быть объявлена
+        // раньше, но такие партии доигрываются до конца
+        if (move >= position.cellCount() || position.winner() != 0 || position.isFull()
+            || position.cell(move) != 0) {
+            return false;
+        }
+
+        if (ply < m_dictionaryPlies) {
+            keys[ply] = position.canonicalHash();
+            canonical[ply] = std::uint8_t(position.canonicalMove(move));
+        } else {
+            canonical[ply] = NoMove;
+        }
+        position.play(move);
+    }
+
+    SizeBuffer &buffer = m_buffers[record.size];
+    std::uint32_t game = std::uint32_t(buffer.results.size());
+    buffer.results.push_back(std::uint8_t(record.result));
+    buffer.lengths.push_back(std::uint16_t(plies));
+    buffer.openings.push_back(plies > 0 ? record.moves[0] : std::uint8_t(NoMove));
+    ++m_games;
+
+    for (int ply = 0; ply < plies; ++ply) {
+        std::uint32_t id = NoPosition;
+        if (ply < m_dictionaryPlies) {
+            auto inserted = m_dictionary.emplace(keys[ply], std::uint32_t(m_keys.size()));
+            if (inserted.second) {
+                m_keys.push_back(keys[ply]);
+                m_positionRows.push_back(0);
+            }
+            id = inserted.first->second;
+            ++m_positionRows[id];
+        }
+
+        buffer.moveGames.push_back(game);
+        buffer.plies.push_back(std::uint8_t(ply));
+        buffer.cells.push_back(record.moves[std::size_t(ply)]);
+        buffer.canonical.push_back(canonical[ply]);
+        buffer.positions.push_back(id);
+        ++m_moves;
+    }
+
+    if (buffer.results.size() == m_blockRows) flush(record.size);
+    return true;
+}
+
+// Блок партий одного размера и их ходы; номера партий выдаются здесь
+void GameStoreWriter::flush(int size)
+{
+    SizeBuffer &buffer = m_buffers[size];
+    if (buffer.results.empty()) return;
+
+    GameBlock block = { m_written, std::uint32_t(buffer.results.size()), std::uint32_t(size) };
+    m_blocks.push_back(block);
+
+    writeValues(m_files[GameSize], std::vector<std::uint8_t>(buffer.results.size(), std::uint8_t(size)));
+    writeValues(m_files[GameResult], buffer.results);
+    writeValues(m_files[GameLength], buffer.lengths);
+    writeValues(m_files[GameOpening], buffer.openings);
+
+    for (std::uint32_t &game : buffer.moveGames) {
+        game += std::uint32_t(m_written);
+    }
+    writeValues(m_files[MoveGame], buffer.moveGames);
+    writeValues(m_files[MovePly], buffer.plies);
+    writeValues(m_files[MoveCell], buffer.cells);
+    writeValues(m_files[MoveCanonical], buffer.canonical);
+    writeValues(m_files[MovePosition], buffer.positions);
+
+    m_written += buffer.results.size();
+    buffer = SizeBuffer();
+}
+
+// Словарь сортируется по хешу, чтобы искать позицию двоичным поиском, а
+// ходы каждой позиции собираются подряд: продолжения позиции читают только
+// её строки, без просмотра всей таблицы ходов
+bool GameStoreWriter::writeIndex()
+{
+    std::vector<std::uint32_t> order(m_keys.size());
+    for (std::size_t id = 0; id < order.size(); ++id) {
+        order[id] = std::uint32_t(id);
+    }
+    std::sort(order.begin(), order.end(), [this](std::uint32_t a, std::uint32_t b) {
+        return m_keys[a] < m_keys[b];
+    });
+
+    std::vector<std::uint32_t> rank(m_keys.size());
+    std::vector<std::uint64_t> sortedKeys(m_keys.size());
+    std::vector<std::uint64_t> offsets(m_keys.size() + 1, 0);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        rank[order[i]] = std::uint32_t(i);
+        sortedKeys[i] = m_keys[order[i]];
+        offsets[i + 1] = offsets[i] + m_positionRows[order[i]];
+    }
+
+    // Ходы раскладываются по позициям за один проход по колонкам, номера
+    // позиций в moves.position заменяются на новые
+    std::vector<std::uint32_t> indexGames(std::size_t(offsets.back()));
+    std::vector<std::uint8_t> indexMoves(std::size_t(offsets.back()));
+    std::vector<std::uint64_t> next(offsets.begin(), offsets.end() - 1);
+
+    const std::string positionPath = filePath(m_directory, ColumnFiles[MovePosition]);
+    std::ifstream positionsIn(positionPath, std::ios::binary);
+    std::ifstream gamesIn(filePath(m_directory, ColumnFiles[MoveGame]), std::ios::binary);
+    std::ifstream canonicalIn(filePath(m_directory, ColumnFiles[MoveCanonical]), std::ios::binary);
+    std::ofstream positionsOut(positionPath + ".tmp", std::ios::binary | std::ios::trunc);
+
+    std::vector<std::uint32_t> positions;
+    std::vector<std::uint32_t> games;
+    std::vector<std::uint8_t> canonical;
+    for (std::uint64_t row = 0; row < m_moves; row += ReadRows) {
+        std::size_t count = std::size_t(std::min<std::uint64_t>(ReadRows, m_moves - row));
+        if (!readValues(positionsIn, positions, count) || !readValues(gamesIn, games, count)
+            || !readValues(canonicalIn, canonical, count)) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (positions[i] == NoPosition) continue;
+            positions[i] = rank[positions[i]];
+            std::uint64_t slot = next[positions[i]]++;
+            indexGames[std::size_t(slot)] = games[i];
+            indexMoves[std::size_t(slot)] = canonical[i];
+        }
+        writeValues(positionsOut, positions);
+    }
+
+    positionsIn.close();
+    positionsOut.close();
+    if (!positionsOut) return false;
+    QFile::remove(QString::fromStdString(positionPath));
+    if (!QFile::rename(QString::fromStdString(positionPath + ".tmp"), QString::fromStdString(positionPath))) {
+        return false;
+    }
+
+    std::ofstream keys(filePath(m_directory, "positions.dict"), std::ios::binary | std::ios::trunc);
+    writeValues(keys, sortedKeys);
+    std::ofstream offsetsOut(filePath(m_directory, "positions.offsets"), std::ios::binary | std::ios::trunc);
+    writeValues(offsetsOut, offsets);
+    std::ofstream gamesOut(filePath(m_directory, "positions.games"), std::ios::binary | std::ios::trunc);
+    writeValues(gamesOut, indexGames);
+    std::ofstream movesOut(filePath(m_directory, "positions.moves"), std::ios::binary | std::ios::trunc);
+    writeValues(movesOut, indexMoves);
+    return keys && offsetsOut && gamesOut && movesOut;
+}
+
+bool GameStoreWriter::finish()
+{
+    if (!m_open || m_finished) return false;
+    m_finished = true;
+
+    for (int size = Position::MinSize; size <= Position::MaxSize; ++size) {
+        flush(size);
+    }
+
+    bool ok = true;
+    for (std::ofstream &file : m_files) {
+        file.close();
+        ok = ok && !file.fail();
+    }
+    ok = ok && writeIndex();
+
+    std::ofstream blocks(filePath(m_directory, "games.blocks"), std::ios::binary | std::ios::trunc);
+    writeValues(blocks, m_blocks);
+    ok = ok && blocks;
+
+    StoreHeader header;
+    std::memcpy(header.magic, StoreMagic, sizeof(StoreMagic));
+    header.blockRows = m_blockRows;
+    header.dictionaryPlies = std::uint32_t(m_dictionaryPlies);
+    header.games = m_games;
+    header.moves = m_moves;
+    header.positions = m_keys.size();
+    header.indexRows = 0;
+    for (std::uint64_t rows : m_positionRows) {
+        header.indexRows += rows;
+    }
+    header.blocks = m_blocks.size();
+
+    if (ok) {
+        std::ofstream meta(filePath(m_directory, "store.meta"), std::ios::binary | std::ios::trunc);
+        meta.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        ok = bool(meta);
+    }
+    return ok;
+}
+
+GameStore::GameStore(const std::string &directory)
+    : m_open(false), m_threads(0), m_directory(directory), m_blockRows(0), m_games(0), m_moves(0),
+      m_positionCount(0), m_indexRows(0), m_blockCount(0)
+{
+    std::ifstream meta(filePath(directory, "store.meta"), std::ios::binary);
+    StoreHeader header;
+    if (!meta.read(reinterpret_cast<char *>(&header), sizeof(header))
+        || std::memcmp(header.magic, StoreMagic, sizeof(StoreMagic)) != 0 || header.blockRows == 0) {
+        return;
+    }
+
+    m_blockRows = header.blockRows;
+    m_games = header.games;
+    m_moves = header.moves;
+    m_positionCount = header.positions;
+    m_indexRows = header.indexRows;
+    m_blockCount = header.blocks;
+
+    // Колонки ходов запросам не нужны - продолжения читаются из индекса
+    m_open = map(m_sizes, "games.size", m_games, 1)
+             && map(m_results, "games.result", m_games, 1)
+             && map(m_lengths, "games.length", m_games, 2)
+             && map(m_openings, "games.opening", m_games, 1)
+             && map(m_keys, "positions.dict", m_positionCount, 8)
+             && map(m_offsets, "positions.offsets", m_positionCount + 1, 8)
+             && map(m_indexGames, "positions.games", m_indexRows, 4)
+             && map(m_indexMoves, "positions.moves", m_indexRows, 1)
+             && map(m_blocks, "games.blocks", m_blockCount, sizeof(GameBlock));
+}
+
+GameStore::~GameStore() = default;
+
+bool GameStore::map(Column &column, const char *name, std::uint64_t count, std::size_t elementSize)
+{
+    if (count == 0) return true;
+
+    std::unique_ptr<QFile> file(new QFile(QString::fromStdString(filePath(m_directory, name))));
+    qint64 bytes = qint64(count * elementSize);
+    if (!file->open(QIODevice::ReadOnly) || file->size() < bytes) return false;
+
+    column.data = file->map(0, bytes);
+    column.file = std::move(file);
+    return column.data != nullptr;
+}
+
+int GameStore::threadCount(std::size_t blocks) const
+{
+    int threads = m_threads > 0 ? m_threads : int(std::thread::hardware_concurrency());
+    return std::max(1, std::min(threads, int(blocks)));
+}
+
+std::vector<GameStore::MoveStats> GameStore::openings(int size) const
+{
+    TRACE_SCOPE("GameStore::openings", "gamestore");
+    std::vector<MoveStats> result;
+    if (!m_open) return result;
+
+    const std::uint8_t *results = column<std::uint8_t>(m_results);
+    const std::uint8_t *openings = column<std::uint8_t>(m_openings);
+    const GameBlock *blocks = column<GameBlock>(m_blocks);
+    std::size_t blockCount = std::size_t(m_blockCount);
+
+    std::vector<std::vector<Outcomes>> locals = parallelScan(
+        blockCount, threadCount(blockCount), std::vector<Outcomes>(MaxCells),
+        [&](std::size_t block, std::vector<Outcomes> &local) {
+            if (blocks[block].size != std::uint32_t(size)) return;
+
+            std::uint64_t begin = blocks[block].firstRow;
+            std::uint64_t end = begin + blocks[block].rows;
+            for (std::uint64_t row = begin; row < end; ++row) {
+                if (openings[row] != NoMove) countResult(local[openings[row]], results[row]);
+            }
+        });
+
+    for (int cell = 0; cell < size * size && cell < MaxCells; ++cell) {
+        MoveStats stats;
+        stats.cell = cell;
+        for (const std::vector<Outcomes> &local : locals) {
+            mergeOutcomes(stats.outcomes, local[std::size_t(cell)]);
+        }
+        if (stats.outcomes.games > 0) result.push_back(stats);
+    }
+    return result;
+}
+
+std::vector<GameStore::SizeStats> GameStore::sizeStats(int size) const
+{
+    TRACE_SCOPE("GameStore::sizeStats", "gamestore");
+    std::vector<SizeStats> result;
+    if (!m_open) return result;
+
+    const std::uint8_t *results = column<std::uint8_t>(m_results);
+    const std::uint16_t *lengths = column<std::uint16_t>(m_lengths);
+    const GameBlock *blocks = column<GameBlock>(m_blocks);
+    std::size_t blockCount = std::size_t(m_blockCount);
+
+    std::vector<SizeStats> initial(Position::MaxSize + 1);
+    for (int s = 0; s <= Position::MaxSize; ++s) {
+        initial[std::size_t(s)].size = s;
+        initial[std::size_t(s)].lengths.assign(std::size_t(s * s + 1), 0);
+    }
+
+    std::vector<std::vector<SizeStats>> locals = parallelScan(
+        blockCount, threadCount(blockCount), initial,
+        [&](std::size_t block, std::vector<SizeStats> &local) {
+            if (size > 0 && blocks[block].size != std::uint32_t(size)) return;
+
+            SizeStats &stats = local[blocks[block].size];
+            std::uint64_t begin = blocks[block].firstRow;
+            std::uint64_t end = begin + blocks[block].rows;
+            for (std::uint64_t row = begin; row < end; ++row) {
+                countResult(stats.outcomes, results[row]);
+                ++stats.lengths[lengths[row]];
+            }
+        });
+
+    for (std::size_t s = Position::MinSize; s <= Position::MaxSize; ++s) {
+        SizeStats stats = initial[s];
+        for (const std::vector<SizeStats> &local : locals) {
+            mergeOutcomes(stats.outcomes, local[s].outcomes);
+            for (std::size_t length = 0; length < stats.lengths.size(); ++length) {
+                stats.lengths[length] += local[s].lengths[length];
+            }
+        }
+        if (stats.outcomes.games > 0) result.push_back(stats);
+    }
+    return result;
+}
+
+std::vector<GameStore::MoveStats> GameStore::continuations(const Position &position) const
+{
+    TRACE_SCOPE("GameStore::continuations", "gamestore");
+    std::vector<MoveStats> result;
+    if (!m_open) return result;
+
+    int symmetry = 0;
+    std::uint64_t key = position.canonicalHash(&symmetry);
+    const std::uint64_t *keys = column<std::uint64_t>(m_keys);
+    const std::uint64_t *found = std::lower_bound(keys, keys + m_positionCount, key);
+    if (found == keys + m_positionCount || *found != key) return result;
+
+    const std::uint64_t *offsets = column<std::uint64_t>(m_offsets);
+    std::uint64_t first = offsets[found - keys];
+    std::uint64_t last = offsets[found - keys + 1];
+
+    // Строки позиции идут подряд; потоки делят их на куски по blockRows
+    const std::uint8_t *results = column<std::uint8_t>(m_results);
+    const std::uint32_t *games = column<std::uint32_t>(m_indexGames);
+    const std::uint8_t *moves = column<std::uint8_t>(m_indexMoves);
+    std::size_t chunkCount = std::size_t((last - first + m_blockRows - 1) / m_blockRows);
+
+    std::vector<std::vector<Outcomes>> locals = parallelScan(
+        chunkCount, threadCount(chunkCount), std::vector<Outcomes>(MaxCells),
+        [&](std::size_t chunk, std::vector<Outcomes> &local) {
+            std::uint64_t begin = first + std::uint64_t(chunk) * m_blockRows;
+            std::uint64_t end = std::min(begin + m_blockRows, last);
+            for (std::uint64_t row = begin; row < end; ++row) {
+                countResult(local[moves[row]], results[games[row]]);
+            }
+        });
+
+    // Ход в канонической ориентации переводим обратно в ориентацию position
+    for (int index = 0; index < position.cellCount(); ++index) {
+        int move = Position::transform(position.size(), symmetry, index);
+        MoveStats stats;
+        stats.cell = index;
+        for (const std::vector<Outcomes> &local : locals) {
+            mergeOutcomes(stats.outcomes, local[std::size_t(move)]);
+        }
+        if (stats.outcomes.games > 0 && position.cell(index) == 0) result.push_back(stats);
+    }
+    return result;
+}
@@ -0,0 +1,175 @@
+#ifndef GAMESTORE_H
+#define GAMESTORE_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "gameengine.h"
+#include "gamerecord.h"
+
+class QFile;
+
+// Колоночное хранилище партий для аналитики. Каталог содержит по файлу на
+// колонку (массивы little-endian), словарь позиций с индексом по нему и
+// описание блоков партий:
+//
+//   games.size, games.result (uint8), games.length (uint16), games.opening (uint8)
+//   moves.game (uint32), moves.ply, moves.cell, moves.canonical (uint8),
+//   moves.position (uint32 - номер в словаре positions.dict)
+//   positions.dict - канонические хеши (uint64) по возрастанию
+//   positions.offsets, positions.games, positions.moves - ходы, сгруппированные
+//     по позиции: у позиции i это строки [offsets[i], offsets[i + 1])
+//   games.blocks - GameBlock на каждый блок партий
+//
+// Позиция в словаре - канонический хеш (с учётом симметрий) до хода,
+// кодируются только первые dictionaryPlies полуходов партии. Партии
+// раскладываются по блокам одного размера поля, поэтому запросы с
+// фильтром по размеру читают только блоки этого размера.
+namespace GameStoreFormat {
+
+enum : std::uint32_t { NoPosition = 0xffffffffu, NoMove = 0xff, DefaultBlockRows = 65536 };
+
+struct GameBlock
+{
+    std::uint64_t firstRow;
+    std::uint32_t rows;
+    std::uint32_t size;
+};
+
+} // namespace GameStoreFormat
+
+class GameStoreWriter
+{
+public:
+    GameStoreWriter(const std::string &directory, int dictionaryPlies = 8,
+                    std::uint32_t blockRows = GameStoreFormat::DefaultBlockRows);
+    ~GameStoreWriter();
+
+    bool isOpen() const { return m_open; }
+
+    // Некорректные партии (занятая клетка, ход после конца) пропускаются.
+    // Номера партий в хранилище идут по блокам размеров, а не по порядку add
+    bool add(const GameRecord &record);
+    bool finish();
+
+    std::uint64_t gameCount() const { return m_games; }
+    std::uint64_t moveCount() const { return m_moves; }
+    std::size_t positionCount() const { return m_keys.size(); }
+
+private:
+    enum Column {
+        GameSize, GameResult, GameLength, GameOpening,
+        MoveGame, MovePly, MoveCell, MoveCanonical, MovePosition,
+        ColumnCount
+    };
+
+    // Партии одного размера поля, ещё не записанные блоком; moveGames -
+    // номер партии внутри буфера
+    struct SizeBuffer
+    {
+        std::vector<std::uint8_t> results;
+        std::vector<std::uint16_t> lengths;
+        std::vector<std::uint8_t> openings;
+        std::vector<std::uint32_t> moveGames;
+        std::vector<std::uint8_t> plies;
+        std::vector<std::uint8_t> cells;
+        std::vector<std::uint8_t> canonical;
+        std::vector<std::uint32_t> positions;
+    };
+
+    void flush(int size);
+    bool writeIndex();
+
+    std::string m_directory;
+    int m_dictionaryPlies;
+    std::uint32_t m_blockRows;
+    bool m_open;
+    bool m_finished;
+    std::uint64_t m_games;
+    std::uint64_t m_moves;
+    std::uint64_t m_written; // партий уже записано блоками
+
+    std::ofstream m_files[ColumnCount];
+    SizeBuffer m_buffers[Position::MaxSize + 1];
+
+    std::vector<GameStoreFormat::GameBlock> m_blocks;
+    // Номер в словаре выдаётся по первому появлению и перенумеровывается
+    // по возрастанию хеша в finish
+    std::unordered_map<std::uint64_t, std::uint32_t> m_dictionary;
+    std::vector<std::uint64_t> m_keys;
+    std::vector<std::uint64_t> m_positionRows;
+};
+
+// Чтение хранилища через отображение файлов в память. Запросы по размеру
+// поля делят между потоками блоки нужного размера, продолжения позиции
+// читают только её строки индекса
+class GameStore
+{
+public:
+    struct Outcomes
+    {
+        std::uint64_t games = 0;
+        std::uint64_t xWins = 0;
+        std::uint64_t draws = 0;
+        std::uint64_t oWins = 0;
+    };
+
+    struct MoveStats
+    {
+        int cell = -1;
+        Outcomes outcomes;
+    };
+
+    struct SizeStats
+    {
+        int size = 0;
+        Outcomes outcomes;
+        std::vector<std::uint64_t> lengths; // число партий по длине
+    };
+
+    explicit GameStore(const std::string &directory);
+    ~GameStore();
+
+    bool isOpen() const { return m_open; }
+    void setThreads(int threads) { m_threads = threads; }
+
+    std::uint64_t gameCount() const { return m_games; }
+    std::uint64_t moveCount() const { return m_moves; }
+    std::uint64_t positionCount() const { return m_positionCount; }
+
+    // Результаты по первому ходу на поле заданного размера
+    std::vector<MoveStats> openings(int size) const;
+    // Результаты и распределение длины партий по размерам поля (0 - все)
+    std::vector<SizeStats> sizeStats(int size = 0) const;
+    // Ходы, сыгранные из позиции или симметричной ей, в ориентации position
+    std::vector<MoveStats> continuations(const Position &position) const;
+
+private:
+    struct Column
+    {
+        std::unique_ptr<QFile> file;
+        const unsigned char *data = nullptr;
+    };
+
+    bool map(Column &column, const char *name, std::uint64_t count, std::size_t elementSize);
+    template <typename T> const T *column(const Column &c) const { return reinterpret_cast<const T *>(c.data); }
+    int threadCount(std::size_t blocks) const;
+
+    bool m_open;
+    int m_threads;
+    std::string m_directory;
+    std::uint32_t m_blockRows;
+    std::uint64_t m_games;
+    std::uint64_t m_moves;
+    std::uint64_t m_positionCount;
+    std::uint64_t m_indexRows;
+    std::uint64_t m_blockCount;
+
+    Column m_sizes, m_results, m_lengths, m_openings;
+    Column m_keys, m_offsets, m_indexGames, m_indexMoves, m_blocks;
+};
+
+#endif // GAMESTORE_H
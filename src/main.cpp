@@ -1,12 +1,63 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
 #include "mainwindow.h"
+#include "metrics.h"
+#include "trace.h"
 
 int main(int argc, char *argv[])
 {
+    // Отсчёт времени запуска - до создания QApplication
+    QElapsedTimer startup;
+    startup.start();
+
     QApplication app(argc, argv);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addOption({ "trace", "Записать трассировку в формате Chrome Trace Event.", "file" });
+    parser.addOption({ "startup-bench", "Вывести время до первого кадра доски и выйти." });
+    parser.addOption({ "metrics", "Собирать метрики с запуска (в окне - Ctrl+M)." });
+    parser.process(app);
+
+    const QString tracePath = parser.value("trace");
+    if (!tracePath.isEmpty()) {
+        Trace::start();
+        Trace::setThreadName("GUI");
+    }
+
+    if (parser.isSet("metrics")) Metrics::setEnabled(true);
+
     MainWindow window;
+    // Время конструктора окна отдельно от первого кадра: движки и стили
+    // окна против раскладки и отрисовки
+    const qint64 constructedNs = startup.nsecsElapsed();
+
+    bool reported = false;
+    if (parser.isSet("startup-bench")) {
+        QObject::connect(window.board(), &GameBoard::framePainted, &app, [&startup, &reported, constructedNs]() {
+            if (reported) return;
+            reported = true;
+            Trace::instant("first frame", "startup");
+            QTextStream(stdout) << QString("Окно создано: %1 мс, первый кадр: %2 мс")
+                                       .arg(constructedNs / 1e6, 0, 'f', 1)
+                                       .arg(startup.nsecsElapsed() / 1e6, 0, 'f', 1)
+                                << Qt::endl;
+            QCoreApplication::quit();
+        });
+    }
+
     window.show();
 
-    return app.exec();
+    int result = app.exec();
+
+    if (!tracePath.isEmpty()) {
+        Trace::stop();
+        if (!Trace::writeChromeTrace(tracePath.toStdString())) {
+            QTextStream(stderr) << QString("Не удалось записать %1").arg(tracePath) << Qt::endl;
+            return 1;
+        }
+    }
+    return result;
 }
@@ -2,82 +2,155 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QMessageBox>
-#include <QFont>
+#include <QRandomGenerator>
+#include <QShortcut>
+#include <QStatusBar>
+#include <QThread>
+#include <QTimer>
+#include "metrics.h"
+#include "selfplaypool.h"
+#include "spectatorgrid.h"
+#include "trace.h"
+
+namespace {
+
+const int SpectatorGames = 64;
+
+const char *const WindowStyleSheet = R"(
+    QMainWindow {
+        background-color: #1e1e1e;
+    }
+    QWidget#centralWidget {
+        background-color: #1e1e1e;
+    }
+    GameBoard {
+        background-color: #1e1e1e;
+    }
+    QPushButton {
+        background-color: qlineargradient(x1:0, y1:0, x2:1, y2:0,
+            stop:0 #4a9cff, stop:1 #3742fa);
+        color: white;
+        border: none;
+        padding: 10px 20px;
+        border-radius: 6px;
+        font-weight: bold;
+        font-size: 12px;
+        min-height: 30px;
+    }
+    QPushButton:hover {
+        background-color: qlineargradient(x1:0, y1:0, x2:1, y2:0,
+            stop:0 #5aaaff, stop:1 #4752ff);
+    }
+    QPushButton:pressed {
+        background-color: qlineargradient(x1:0, y1:0, x2:1, y2:0,
+            stop:0 #3a8cff, stop:1 #2732ff);
+    }
+    QSpinBox {
+        background-color: #2b2b2b;
+        color: white;
+        border: 2px solid #4a4a4a;
+        padding: 6px;
+        border-radius: 4px;
+        selection-background-color: #4a9cff;
+    }
+    QSpinBox::up-button, QSpinBox::down-button {
+        background-color: #3a3a3a;
+        border: 1px solid #4a4a4a;
+        border-radius: 2px;
+    }
+    QSpinBox::up-button:hover, QSpinBox::down-button:hover {
+        background-color: #4a4a4a;
+    }
+    QComboBox {
+        background-color: #2b2b2b;
+        color: white;
+        border: 2px solid #4a4a4a;
+        padding: 6px;
+        border-radius: 4px;
+        selection-background-color: #4a9cff;
+    }
+    QComboBox QAbstractItemView {
+        background-color: #2b2b2b;
+        color: white;
+        selection-background-color: #4a9cff;
+    }
+    QCheckBox {
+        color: #e0e0e0;
+        font-weight: bold;
+    }
+    QLabel {
+        color: #e0e0e0;
+        font-weight: bold;
+    }
+    QLabel#currentPlayerLabel {
+        font-family: Arial;
+        color: #ff6b6b;
+        font-size: 14px;
+        font-weight: bold;
+    }
+    QLabel#scoreXLabel {
+        font-family: Arial;
+        color: #ff6b6b;
+        font-weight: bold;
+        font-size: 13px;
+    }
+    QLabel#scoreOLabel {
+        font-family: Arial;
+        color: #4a9cff;
+        font-weight: bold;
+        font-size: 13px;
+    }
+    QLabel#scoreDrawLabel {
+        font-family: Arial;
+        color: #aaaaaa;
+        font-weight: bold;
+        font-size: 13px;
+    }
+    QLabel#engineLabel, QLabel#throughputLabel {
+        color: #aaaaaa;
+        font-size: 12px;
+    }
+    QStatusBar {
+        color: #aaaaaa;
+    }
+    QMessageBox {
+        background-color: #2b2b2b;
+    }
+    QMessageBox QLabel {
+        color: white;
+        font-size: 14px;
+    }
+    QMessageBox QPushButton {
+        background-color: #4a9cff;
+        color: white;
+        border: none;
+        padding: 8px 20px;
+        border-radius: 4px;
+        font-weight: bold;
+        min-width: 80px;
+    }
+    QMessageBox QPushButton:hover {
+        background-color: #5aaaff;
+    }
+)";
+
+} // namespace
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), gameLogic(new GameLogic(this)),
-      scoreX(0), scoreO(0), scoreDraw(0)
+      enginePlayer(new EnginePlayer(gameLogic, this)),
+      autoPlayer(new EnginePlayer(gameLogic, this)),
+      analysisWorker(new AnalysisWorker(gameLogic, this)),
+      throughputLabel(nullptr), metricsOverlay(nullptr), metricsCollection(Metrics::enabled()),
+      scoreX(0), scoreO(0), scoreDraw(0), autoPlayGames(0)
 {
+    TRACE_SCOPE("MainWindow::MainWindow", "startup");
+
+    // Стиль задаётся до создания виджетов: каждый полируется один раз, а не
+    // повторно при смене таблицы стилей. Диалоги окна наследуют его же.
+    // Партию начинать не нужно - GameLogic создаётся с пустым полем.
+    setStyleSheet(WindowStyleSheet);
     setupUI();
-    onNewGame();
-
-    setStyleSheet(R"(
-        QMainWindow {
-            background-color: #1e1e1e;
-        }
-        QWidget#centralWidget {
-            background-color: #1e1e1e;
-        }
-        QPushButton {
-            background-color: qlineargradient(x1:0, y1:0, x2:1, y2:0,
-                stop:0 #4a9cff, stop:1 #3742fa);
-            color: white;
-            border: none;
-            padding: 10px 20px;
-            border-radius: 6px;
-            font-weight: bold;
-            font-size: 12px;
-            min-height: 30px;
-        }
-        QPushButton:hover {
-            background-color: qlineargradient(x1:0, y1:0, x2:1, y2:0,
-                stop:0 #5aaaff, stop:1 #4752ff);
-        }
-        QPushButton:pressed {
-            background-color: qlineargradient(x1:0, y1:0, x2:1, y2:0,
-                stop:0 #3a8cff, stop:1 #2732ff);
-        }
-        QSpinBox {
-            background-color: #2b2b2b;
-            color: white;
-            border: 2px solid #4a4a4a;
-            padding: 6px;
-            border-radius: 4px;
-            selection-background-color: #4a9cff;
-        }
-        QSpinBox::up-button, QSpinBox::down-button {
-            background-color: #3a3a3a;
-            border: 1px solid #4a4a4a;
-            border-radius: 2px;
-        }
-        QSpinBox::up-button:hover, QSpinBox::down-button:hover {
-            background-color: #4a4a4a;
-        }
-        QLabel {
-            color: #e0e0e0;
-            font-weight: bold;
-        }
-        QLabel#currentPlayerLabel {
-            color: #ff6b6b;
-            font-size: 14px;
-            font-weight: bold;
-        }
-        QLabel#scoreXLabel {
-            color: #ff6b6b;
-            font-weight: bold;
-            font-size: 13px;
-        }
-        QLabel#scoreOLabel {
-            color: #4a9cff;
-            font-weight: bold;
-            font-size: 13px;
-        }
-        QLabel#scoreDrawLabel {
-            color: #aaaaaa;
-            font-weight: bold;
-            font-size: 13px;
-        }
-    )");
 }
 
 void MainWindow::setupUI()
@@ -98,9 +171,26 @@ void MainWindow::setupUI()
     boardSizeSpinBox->setValue(3);
     boardSizeSpinBox->setPrefix("Размер: ");
 
+    spectatorButton = new QPushButton("НАБЛЮДЕНИЕ", this);
+
+    opponentComboBox = new QComboBox(this);
+    opponentComboBox->addItem("Против игрока");
+    opponentComboBox->addItem("Компьютер за O");
+    opponentComboBox->addItem("Компьютер за X");
+    opponentComboBox->addItem("Компьютер против компьютера");
+
+    ponderCheckBox = new QCheckBox("Думать на ходу соперника", this);
+    ponderCheckBox->setChecked(enginePlayer->isPondering());
+
+    analysisCheckBox = new QCheckBox("Анализ", this);
+
     controlLayout->addWidget(newGameButton);
     controlLayout->addWidget(boardSizeSpinBox);
+    controlLayout->addWidget(opponentComboBox);
+    controlLayout->addWidget(ponderCheckBox);
+    controlLayout->addWidget(analysisCheckBox);
     controlLayout->addStretch();
+    controlLayout->addWidget(spectatorButton);
 
     QHBoxLayout *statusLayout = new QHBoxLayout();
 
@@ -116,7 +206,12 @@ void MainWindow::setupUI()
     scoreDrawLabel = new QLabel("Ничьи: 0", this);
     scoreDrawLabel->setObjectName("scoreDrawLabel");
 
+    engineLabel = new QLabel(this);
+    engineLabel->setObjectName("engineLabel");
+
     statusLayout->addWidget(currentPlayerLabel);
+    statusLayout->addSpacing(15);
+    statusLayout->addWidget(engineLabel);
     statusLayout->addStretch();
     statusLayout->addWidget(scoreXLabel);
     statusLayout->addSpacing(15);
@@ -132,10 +227,26 @@ void MainWindow::setupUI()
     mainLayout->addWidget(gameBoard, 1);
 
     connect(newGameButton, &QPushButton::clicked, this, &MainWindow::onNewGame);
+    connect(spectatorButton, &QPushButton::clicked, this, &MainWindow::onShowSpectator);
+    connect(new QShortcut(QKeySequence(Qt::Key_F3), this), &QShortcut::activated,
+            this, &MainWindow::onToggleMetrics);
+    connect(new QShortcut(QKeySequence("Ctrl+E"), this), &QShortcut::activated,
+            this, &MainWindow::onExportMetrics);
+    connect(new QShortcut(QKeySequence("Ctrl+M"), this), &QShortcut::activated,
+            this, &MainWindow::onToggleMetricsCollection);
     connect(boardSizeSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
             this, &MainWindow::onBoardSizeChanged);
+    connect(opponentComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onOpponentChanged);
+    connect(ponderCheckBox, &QCheckBox::toggled, enginePlayer, &EnginePlayer::setPondering);
+    connect(ponderCheckBox, &QCheckBox::toggled, autoPlayer, &EnginePlayer::setPondering);
+    connect(enginePlayer, &EnginePlayer::moveMade, this, &MainWindow::onEngineMoveMade);
+    connect(analysisCheckBox, &QCheckBox::toggled, analysisWorker, &AnalysisWorker::setEnabled);
+    connect(analysisCheckBox, &QCheckBox::toggled, gameBoard, &GameBoard::setHeatmapVisible);
+    connect(analysisWorker, &AnalysisWorker::heatmapReady, gameBoard, &GameBoard::setHeatmap);
     connect(gameLogic, &GameLogic::gameFinished, this, &MainWindow::onGameFinished);
     connect(gameLogic, &GameLogic::currentPlayerChanged, [this](GameLogic::Player player) {
+        updateInteractive();
         QString color = (player == GameLogic::PlayerX) ? "#ff6b6b" : "#4a9cff";
         QString symbol = (player == GameLogic::PlayerX) ? "X" : "O";
         currentPlayerLabel->setText(QString("<span style='color: %1'> Ход: %2 %3</span>")
@@ -143,15 +254,6 @@ void MainWindow::setupUI()
                                    .arg(symbol)
                                    .arg(player == GameLogic::PlayerX ? "X" : "O"));
     });
-    connect(gameLogic, &GameLogic::boardSizeChanged, gameBoard, &GameBoard::updateSize);
-
-    QFont titleFont("Arial", 12, QFont::Bold);
-    QFont scoreFont("Arial", 11, QFont::Bold);
-
-    currentPlayerLabel->setFont(titleFont);
-    scoreXLabel->setFont(scoreFont);
-    scoreOLabel->setFont(scoreFont);
-    scoreDrawLabel->setFont(scoreFont);
 
     resize(800, 650);
 }
@@ -161,12 +263,147 @@ void MainWindow::onNewGame()
     gameLogic->newGame();
     gameBoard->update();
     currentPlayerLabel->setText("Ход: X");
+    if (isAutoPlay()) playRandomOpening();
+}
+
+// Оба движка детерминированы и таблица очищается перед партией, поэтому
+// без случайного первого хода автоигра повторяла бы одну и ту же партию
+void MainWindow::playRandomOpening()
+{
+    int size = gameLogic->boardSize();
+    int cell = QRandomGenerator::global()->bounded(size * size);
+    gameLogic->makeMove(cell / size, cell % size);
 }
 
 void MainWindow::onBoardSizeChanged(int size)
 {
+    // setBoardSize сам начинает новую партию при смене размера
     gameLogic->setBoardSize(size);
-    onNewGame();
+    if (isAutoPlay()) playRandomOpening();
+}
+
+void MainWindow::onOpponentChanged(int index)
+{
+    GameLogic::Player side = GameLogic::PlayerNone;
+    if (index == 1) side = GameLogic::PlayerO;
+    else if (index == 2) side = GameLogic::PlayerX;
+
+    // В режиме автоигры O - основной движок, X - второй, партии идут без пауз
+    bool autoPlay = index == 3;
+    if (autoPlay) side = GameLogic::PlayerO;
+
+    GameEngine::Config config = EnginePlayer::defaultConfig();
+    if (autoPlay) {
+        config.maxDepth = 4;
+        config.timeLimitMs = 100;
+    }
+    enginePlayer->setConfig(config);
+    autoPlayer->setConfig(config);
+
+    autoPlayer->setSide(autoPlay ? GameLogic::PlayerX : GameLogic::PlayerNone);
+    enginePlayer->setSide(side);
+    engineLabel->clear();
+    updateInteractive();
+
+    autoPlayGames = 0;
+    autoPlayTimer.start();
+    // Автоигра на законченной партии сама не начнётся: на пустом поле
+    // делаем первый ход, после конца партии начинаем новую
+    if (autoPlay) {
+        if (gameLogic->gameState() != GameLogic::StatePlaying) onNewGame();
+        else if (gameLogic->moveCount() == 0) playRandomOpening();
+    }
+    if (throughputLabel) throughputLabel->clear();
+    statusBar()->clearMessage();
+}
+
+void MainWindow::onEngineMoveMade(int row, int col, qint64 latencyMs)
+{
+    Q_UNUSED(row);
+    Q_UNUSED(col);
+    engineLabel->setText(QString("Компьютер: %1 мс").arg(latencyMs));
+}
+
+void MainWindow::onShowSpectator()
+{
+    SpectatorGrid *grid = new SpectatorGrid();
+    grid->setAttribute(Qt::WA_DeleteOnClose);
+
+    GameEngine::Config config;
+    config.name = "spectator";
+    config.maxDepth = 4;
+    config.timeLimitMs = 50;
+    config.hashSizeMb = 4;
+
+    // Пул и партии принадлежат окну и уничтожаются вместе с ним
+    SelfPlayPool *pool = new SelfPlayPool(config, QThread::idealThreadCount(), grid);
+    connect(pool, &SelfPlayPool::gameFinished, grid, &SpectatorGrid::addResult);
+    for (int i = 0; i < SpectatorGames; ++i) {
+        GameLogic *logic = new GameLogic(pool);
+        logic->setBoardSize(gameLogic->boardSize());
+        grid->addGame(logic);
+        pool->addGame(logic);
+    }
+
+    grid->resize(900, 900);
+    grid->show();
+}
+
+void MainWindow::onToggleMetrics()
+{
+    if (!metricsOverlay) {
+        metricsOverlay = new MetricsOverlay(gameBoard);
+        metricsOverlay->move(10, 10);
+    }
+    metricsOverlay->toggle();
+    updateMetricsCollection();
+}
+
+void MainWindow::onExportMetrics()
+{
+    const QString path = "metrics.prom";
+    if (Metrics::writePrometheus(path.toStdString())) {
+        QString message = QString("Метрики сохранены в %1").arg(path);
+        if (!Metrics::enabled()) message += " (сбор выключен, Ctrl+M - включить)";
+        statusBar()->showMessage(message, 5000);
+    } else {
+        statusBar()->showMessage(QString("Не удалось записать %1").arg(path), 5000);
+    }
+}
+
+void MainWindow::onToggleMetricsCollection()
+{
+    metricsCollection = !metricsCollection;
+    updateMetricsCollection();
+    statusBar()->showMessage(metricsCollection ? "Сбор метрик включён" : "Сбор метрик выключен", 3000);
+}
+
+// Метрики собираются, пока включён сбор или открыта панель
+void MainWindow::updateMetricsCollection()
+{
+    Metrics::setEnabled(metricsCollection || (metricsOverlay && metricsOverlay->isVisible()));
+}
+
+void MainWindow::updateInteractive()
+{
+    gameBoard->setInteractive(!isAutoPlay()
+                              && (enginePlayer->side() == GameLogic::PlayerNone
+                                  || gameLogic->currentPlayer() != enginePlayer->side()));
+}
+
+void MainWindow::updateThroughput()
+{
+    double minutes = autoPlayTimer.elapsed() / 60000.0;
+    double rate = minutes > 0 ? autoPlayGames / minutes : 0.0;
+
+    if (!throughputLabel) {
+        throughputLabel = new QLabel(this);
+        throughputLabel->setObjectName("throughputLabel");
+        statusBar()->addPermanentWidget(throughputLabel);
+    }
+    throughputLabel->setText(QString("Партий: %1  (%2 в минуту)")
+                             .arg(autoPlayGames)
+                             .arg(rate, 0, 'f', 1));
 }
 
 void MainWindow::updateScores()
@@ -193,6 +430,19 @@ void MainWindow::onGameFinished(GameLogic::Player winner)
 
     updateScores();
 
+    // Без модального диалога: итог в строку состояния, следующая партия
+    // запускается из цикла событий, а не изнутри GameLogic::makeMove
+    if (isAutoPlay()) {
+        ++autoPlayGames;
+        updateThroughput();
+        statusBar()->showMessage(QString("Партия %1:%2").arg(autoPlayGames).arg(message));
+        // Режим могли выключить до срабатывания таймера
+        QTimer::singleShot(0, this, [this]() {
+            if (isAutoPlay()) onNewGame();
+        });
+        return;
+    }
+
     QMessageBox msgBox(this);
     msgBox.setWindowTitle("Игра окончена");
     msgBox.setText(QString("<center><b>%1</b></center>").arg(message));
@@ -200,28 +450,6 @@ void MainWindow::onGameFinished(GameLogic::Player winner)
     msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
     msgBox.setDefaultButton(QMessageBox::Yes);
 
-    msgBox.setStyleSheet(R"(
-        QMessageBox {
-            background-color: #2b2b2b;
-        }
-        QMessageBox QLabel {
-            color: white;
-            font-size: 14px;
-        }
-        QMessageBox QPushButton {
-            background-color: #4a9cff;
-            color: white;
-            border: none;
-            padding: 8px 20px;
-            border-radius: 4px;
-            font-weight: bold;
-            min-width: 80px;
-        }
-        QMessageBox QPushButton:hover {
-            background-color: #5aaaff;
-        }
-    )");
-
     if (msgBox.exec() == QMessageBox::Yes) {
         onNewGame();
     }
@@ -5,8 +5,14 @@
 #include <QLabel>
 #include <QSpinBox>
 #include <QPushButton>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QElapsedTimer>
+#include "analysisworker.h"
+#include "engineplayer.h"
 #include "gameboard.h"
 #include "gamelogic.h"
+#include "metricsoverlay.h"
 
 class MainWindow : public QMainWindow
 {
@@ -15,17 +21,33 @@ class MainWindow : public QMainWindow
 public:
     explicit MainWindow(QWidget *parent = nullptr);
 
+    GameBoard *board() const { return gameBoard; }
+
 private slots:
     void onNewGame();
     void onGameFinished(GameLogic::Player winner);
     void onBoardSizeChanged(int size);
+    void onOpponentChanged(int index);
+    void onEngineMoveMade(int row, int col, qint64 latencyMs);
+    void onShowSpectator();
+    void onToggleMetrics();
+    void onExportMetrics();
+    void onToggleMetricsCollection();
 
 private:
     void setupUI();
     void updateScores();
+    void updateInteractive();
+    void updateThroughput();
+    void playRandomOpening();
+    void updateMetricsCollection();
+    bool isAutoPlay() const { return autoPlayer->side() != GameLogic::PlayerNone; }
 
     GameBoard *gameBoard;
     GameLogic *gameLogic;
+    EnginePlayer *enginePlayer;
+    EnginePlayer *autoPlayer;
+    AnalysisWorker *analysisWorker;
 
     QLabel *scoreXLabel;
     QLabel *scoreOLabel;
@@ -33,10 +55,21 @@ private:
     QLabel *currentPlayerLabel;
     QSpinBox *boardSizeSpinBox;
     QPushButton *newGameButton;
+    QPushButton *spectatorButton;
+    QComboBox *opponentComboBox;
+    QCheckBox *ponderCheckBox;
+    QCheckBox *analysisCheckBox;
+    QLabel *engineLabel;
+    QLabel *throughputLabel;
+    MetricsOverlay *metricsOverlay;
+    bool metricsCollection;
 
     int scoreX;
     int scoreO;
     int scoreDraw;
+
+    QElapsedTimer autoPlayTimer;
+    int autoPlayGames;
 };
 
 #endif
@@ -0,0 +1,224 @@
+#include "metrics.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+Histogram::Histogram()
+{
+    reset();
+}
+
+void Histogram::reset()
+{
+    for (auto &bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+int Histogram::bucketIndex(std::uint64_t value)
+{
+    if (value < SubBuckets) return int(value);
+
+    int exponent = 63;
+#if defined(__GNUC__) || defined(__clang__)
+    exponent -= __builtin_clzll(value);
+#else
+    while (!(value >> exponent)) --exponent;
+#endif
+    int mantissa = int(value >> (exponent - SubBucketBits)) & (SubBuckets - 1);
+    return (exponent - SubBucketBits + 1) * SubBuckets + mantissa;
+}
+
+std::uint64_t Histogram::bucketUpperBound(int index)
+{
+    if (index < SubBuckets) return std::uint64_t(index);
+
+    int shift = index / SubBuckets - 1;
+    std::uint64_t mantissa = std::uint64_t(SubBuckets + index % SubBuckets);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void Histogram::record(std::uint64_t value)
+{
+    m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    std::uint64_t current = m_max.load(std::memory_order_relaxed);
+    while (value > current
+           && !m_max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+std::uint64_t Histogram::quantile(double q) const
+{
+    std::uint64_t total = count();
+    if (total == 0) return 0;
+
+    std::uint64_t rank = std::uint64_t(q * double(total - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (int index = 0; index < BucketCount; ++index) {
+        seen += bucket(index);
+        if (seen >= rank) {
+            std::uint64_t bound = bucketUpperBound(index);
+            return bound < max() ? bound : max();
+        }
+    }
+    return max();
+}
+
+namespace Metrics {
+
+std::atomic<bool> g_enabled(false);
+
+namespace {
+
+struct Registry
+{
+    Histogram histograms[HistogramCount];
+    std::atomic<std::uint64_t> counters[CounterCount];
+
+    Registry()
+    {
+        for (auto &counter : counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+struct HistogramInfo
+{
+    const char *name;
+    const char *help;
+    double scale; // множитель для перевода в единицы экспорта
+};
+
+const HistogramInfo HistogramInfos[HistogramCount] = {
+    { "tictactoe_make_move_seconds", "GameLogic::makeMove latency excluding signal handlers.", 1e-9 },
+    { "tictactoe_win_check_seconds", "Win check latency.", 1e-9 },
+    { "tictactoe_draw_check_seconds", "Draw check latency.", 1e-9 },
+    { "tictactoe_search_seconds", "Engine search wall time.", 1e-9 },
+    { "tictactoe_search_depth", "Completed engine search depth.", 1.0 },
+    { "tictactoe_search_nodes_per_second", "Engine search speed.", 1.0 },
+    { "tictactoe_paint_seconds", "GameBoard::paintEvent frame time.", 1e-9 },
+};
+
+const char *const CounterNames[CounterCount][2] = {
+    { "tictactoe_moves_total", "Moves made through GameLogic." },
+    { "tictactoe_searches_total", "Engine searches (pondering excluded)." },
+    { "tictactoe_search_nodes_total", "Nodes visited by engine searches." },
+    { "tictactoe_frames_total", "GameBoard frames painted." },
+};
+
+void appendLine(std::string &out, const char *format, const char *name, double value)
+{
+    char line[256];
+    std::snprintf(line, sizeof(line), format, name, value);
+    out += line;
+}
+
+} // namespace
+
+void setEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void reset()
+{
+    for (auto &histogram : registry().histograms) {
+        histogram.reset();
+    }
+    for (auto &counter : registry().counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+Histogram &histogram(HistogramId id)
+{
+    return registry().histograms[id];
+}
+
+std::uint64_t counter(CounterId id)
+{
+    return registry().counters[id].load(std::memory_order_relaxed);
+}
+
+void add(CounterId id, std::uint64_t value)
+{
+    if (enabled()) {
+        registry().counters[id].fetch_add(value, std::memory_order_relaxed);
+    }
+}
+
+void record(HistogramId id, std::uint64_t value)
+{
+    if (enabled()) {
+        registry().histograms[id].record(value);
+    }
+}
+
+std::uint64_t nowNs()
+{
+    using namespace std::chrono;
+    return std::uint64_t(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+std::string prometheusText()
+{
+    std::string out;
+
+    for (int id = 0; id < CounterCount; ++id) {
+        out += std::string("# HELP ") + CounterNames[id][0] + " " + CounterNames[id][1] + "\n";
+        out += std::string("# TYPE ") + CounterNames[id][0] + " counter\n";
+        appendLine(out, "%s %.0f\n", CounterNames[id][0], double(counter(CounterId(id))));
+    }
+
+    for (int id = 0; id < HistogramCount; ++id) {
+        const HistogramInfo &info = HistogramInfos[id];
+        const Histogram &h = histogram(HistogramId(id));
+        out += std::string("# HELP ") + info.name + " " + info.help + "\n";
+        out += std::string("# TYPE ") + info.name + " histogram\n";
+
+        // Пустые корзины пропускаем: границы le в Prometheus произвольны
+        std::uint64_t cumulative = 0;
+        for (int index = 0; index < Histogram::BucketCount; ++index) {
+            std::uint64_t value = h.bucket(index);
+            if (value == 0) continue;
+
+            cumulative += value;
+            char line[256];
+            std::snprintf(line, sizeof(line), "%s_bucket{le=\"%.9g\"} %llu\n", info.name,
+                          double(Histogram::bucketUpperBound(index)) * info.scale,
+                          static_cast<unsigned long long>(cumulative));
+            out += line;
+        }
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %llu\n", info.name,
+                      static_cast<unsigned long long>(h.count()));
+        out += line;
+        appendLine(out, "%s_sum %.9g\n", info.name, double(h.sum()) * info.scale);
+        appendLine(out, "%s_count %.0f\n", info.name, double(h.count()));
+    }
+
+    return out;
+}
+
+bool writePrometheus(const std::string &path)
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    file << prometheusText();
+    return bool(file);
+}
+
+} // namespace Metrics
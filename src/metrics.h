@@ -0,0 +1,96 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Гистограмма в духе HDR: 8 поддиапазонов на каждую степень двойки
+// (погрешность до 12.5%), запись - одна атомарная операция без блокировок
+class Histogram
+{
+public:
+    enum { SubBucketBits = 3, SubBuckets = 1 << SubBucketBits, BucketCount = 62 * SubBuckets };
+
+    Histogram();
+
+    void record(std::uint64_t value);
+    void reset();
+
+    std::uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    std::uint64_t sum() const { return m_sum.load(std::memory_order_relaxed); }
+    std::uint64_t max() const { return m_max.load(std::memory_order_relaxed); }
+    std::uint64_t bucket(int index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+    std::uint64_t quantile(double q) const;
+
+    static int bucketIndex(std::uint64_t value);
+    static std::uint64_t bucketUpperBound(int index);
+
+private:
+    std::atomic<std::uint64_t> m_buckets[BucketCount];
+    std::atomic<std::uint64_t> m_count;
+    std::atomic<std::uint64_t> m_sum;
+    std::atomic<std::uint64_t> m_max;
+};
+
+namespace Metrics {
+
+enum HistogramId {
+    MakeMoveNs,
+    WinCheckNs,
+    DrawCheckNs,
+    SearchNs,
+    SearchDepth,
+    SearchNodesPerSecond,
+    PaintNs,
+    HistogramCount
+};
+
+enum CounterId {
+    Moves,
+    Searches,
+    SearchNodes,
+    Frames,
+    CounterCount
+};
+
+extern std::atomic<bool> g_enabled;
+
+// Выключенный сбор стоит одной relaxed-загрузки флага на точку замера
+inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool enabled);
+void reset();
+
+Histogram &histogram(HistogramId id);
+std::uint64_t counter(CounterId id);
+void add(CounterId id, std::uint64_t value = 1);
+void record(HistogramId id, std::uint64_t value);
+
+std::uint64_t nowNs();
+
+// Текстовый формат Prometheus; длительности экспортируются в секундах
+std::string prometheusText();
+bool writePrometheus(const std::string &path);
+
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(HistogramId id) : m_id(id), m_start(enabled() ? nowNs() : 0) {}
+    ~ScopedTimer() { stop(); }
+
+    void stop()
+    {
+        if (m_start != 0) {
+            record(m_id, nowNs() - m_start);
+            m_start = 0;
+        }
+    }
+
+private:
+    HistogramId m_id;
+    std::uint64_t m_start;
+};
+
+} // namespace Metrics
+
+#endif // METRICS_H
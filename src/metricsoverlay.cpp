@@ -0,0 +1,82 @@
+#include "metricsoverlay.h"
+#include <QFont>
+#include <QStringList>
+#include "metrics.h"
+
+namespace {
+
+QString formatNs(std::uint64_t ns)
+{
+    if (ns >= 1000000) return QString("%1 мс").arg(ns / 1e6, 0, 'f', 1);
+    return QString("%1 мкс").arg(ns / 1e3, 0, 'f', 1);
+}
+
+QString latencyLine(const QString &title, Metrics::HistogramId id)
+{
+    const Histogram &h = Metrics::histogram(id);
+    return QString("%1 n=%2  p50 %3  p99 %4  max %5")
+        .arg(title, -10)
+        .arg(h.count())
+        .arg(formatNs(h.quantile(0.5)))
+        .arg(formatNs(h.quantile(0.99)))
+        .arg(formatNs(h.max()));
+}
+
+} // namespace
+
+MetricsOverlay::MetricsOverlay(QWidget *parent)
+    : QLabel(parent), m_timer(new QTimer(this))
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setStyleSheet("QLabel { background-color: rgba(0, 0, 0, 170); color: #e0e0e0;"
+                  " padding: 8px; border-radius: 4px; font-weight: normal; }");
+
+    QFont font("Monospace", 9);
+    font.setStyleHint(QFont::TypeWriter);
+    setFont(font);
+
+    m_timer->setInterval(500);
+    connect(m_timer, &QTimer::timeout, this, &MetricsOverlay::refresh);
+    hide();
+}
+
+void MetricsOverlay::toggle()
+{
+    setVisible(!isVisible());
+}
+
+void MetricsOverlay::showEvent(QShowEvent *event)
+{
+    QLabel::showEvent(event);
+    refresh();
+    raise();
+    m_timer->start();
+}
+
+void MetricsOverlay::hideEvent(QHideEvent *event)
+{
+    QLabel::hideEvent(event);
+    m_timer->stop();
+}
+
+void MetricsOverlay::refresh()
+{
+    const Histogram &depth = Metrics::histogram(Metrics::SearchDepth);
+    const Histogram &nps = Metrics::histogram(Metrics::SearchNodesPerSecond);
+
+    QStringList lines;
+    lines << latencyLine("makeMove", Metrics::MakeMoveNs)
+          << latencyLine("победа", Metrics::WinCheckNs)
+          << latencyLine("ничья", Metrics::DrawCheckNs)
+          << latencyLine("поиск", Metrics::SearchNs)
+          << QString("%1 узлов=%2  глубина p50 %3  max %4  узлов/с p50 %5")
+                 .arg(QString(), -10)
+                 .arg(Metrics::counter(Metrics::SearchNodes))
+                 .arg(depth.quantile(0.5))
+                 .arg(depth.max())
+                 .arg(nps.quantile(0.5))
+          << latencyLine("кадр", Metrics::PaintNs);
+
+    setText(lines.join('\n'));
+    adjustSize();
+}
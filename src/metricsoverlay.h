@@ -0,0 +1,30 @@
+#ifndef METRICSOVERLAY_H
+#define METRICSOVERLAY_H
+
+#include <QLabel>
+#include <QTimer>
+
+// Полупрозрачная панель поверх доски со сводкой метрик. Сбор метрик
+// включает MainWindow: пока панель открыта, он включён независимо от Ctrl+M.
+class MetricsOverlay : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsOverlay(QWidget *parent = nullptr);
+
+public slots:
+    void toggle();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void refresh();
+
+private:
+    QTimer *m_timer;
+};
+
+#endif // METRICSOVERLAY_H
@@ -0,0 +1,175 @@
+#include "openingbook.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+const char BookMagic[8] = { 'T', 'T', 'T', 'B', 'O', 'O', 'K', '1' };
+
+struct BookHeader
+{
+    char magic[8];
+    std::uint32_t entrySize;
+    std::uint32_t count;
+};
+
+static_assert(sizeof(OpeningBook::Entry) == 24, "book entry layout is part of the file format");
+static_assert(sizeof(BookHeader) == 16, "book header layout is part of the file format");
+
+bool entryLess(const OpeningBook::Entry &a, const OpeningBook::Entry &b)
+{
+    return a.key < b.key || (a.key == b.key && a.move < b.move);
+}
+
+} // namespace
+
+OpeningBook::OpeningBook(const std::string &path)
+    : m_path(path), m_entries(nullptr), m_count(0)
+{
+}
+
+OpeningBook::~OpeningBook() = default;
+
+OpeningBook &OpeningBook::defaultBook()
+{
+    // Объект создаёт первый EnginePlayer; файл открывается и отображается
+    // в память только при первом probe, то есть при первом поиске
+    static OpeningBook book(QCoreApplication::applicationDirPath().toStdString() + "/book.bin");
+    return book;
+}
+
+void OpeningBook::load() const
+{
+    std::unique_ptr<QFile> file(new QFile(QString::fromStdString(m_path)));
+    if (!file->open(QIODevice::ReadOnly) || file->size() < qint64(sizeof(BookHeader))) return;
+
+    const uchar *data = file->map(0, file->size());
+    if (!data) return;
+
+    BookHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, BookMagic, sizeof(BookMagic)) != 0
+        || header.entrySize != sizeof(Entry)
+        || qint64(sizeof(BookHeader) + std::uint64_t(header.count) * sizeof(Entry)) > file->size()) {
+        return;
+    }
+
+    m_entries = reinterpret_cast<const Entry *>(data + sizeof(BookHeader));
+    m_count = header.count;
+    m_file = std::move(file);
+}
+
+bool OpeningBook::isLoaded() const
+{
+    std::call_once(m_loaded, [this]() { load(); });
+    return m_entries != nullptr;
+}
+
+std::size_t OpeningBook::size() const
+{
+    return isLoaded() ? m_count : 0;
+}
+
+int OpeningBook::probe(const Position &position) const
+{
+    if (!isLoaded()) return -1;
+
+    int symmetry = 0;
+    std::uint64_t key = position.canonicalHash(&symmetry);
+
+    const Entry *end = m_entries + m_count;
+    const Entry *it = std::lower_bound(m_entries, end, key, [](const Entry &entry, std::uint64_t value) {
+        return entry.key < value;
+    });
+
+    // Лучший ход по среднему результату, при равенстве - более сыгранный
+    const Entry *best = nullptr;
+    for (; it != end && it->key == key; ++it) {
+        if (!best || std::uint64_t(it->points) * best->games > std::uint64_t(best->points) * it->games
+            || (std::uint64_t(it->points) * best->games == std::uint64_t(best->points) * it->games
+                && it->games > best->games)) {
+            best = it;
+        }
+    }
+    if (!best) return -1;
+
+    for (int index = 0; index < position.cellCount(); ++index) {
+        if (Position::transform(position.size(), symmetry, index) == best->move) {
+            return position.cell(index) == 0 ? index : -1;
+        }
+    }
+    return -1;
+}
+
+bool OpeningBook::write(const std::string &path, std::vector<Entry> entries)
+{
+    std::sort(entries.begin(), entries.end(), entryLess);
+
+    BookHeader header;
+    std::memcpy(header.magic, BookMagic, sizeof(BookMagic));
+    header.entrySize = sizeof(Entry);
+    header.count = std::uint32_t(entries.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(entries.data()), std::streamsize(entries.size() * sizeof(Entry)));
+    return bool(out);
+}
+
+BookBuilder::BookBuilder(int maxPlies)
+    : m_maxPlies(maxPlies), m_games(0)
+{
+}
+
+bool BookBuilder::addGame(const GameRecord &record)
+{
+    if (record.size < Position::MinSize || record.size > Position::MaxSize) return false;
+
+    // Сначала проверяем партию целиком, чтобы не учесть начало некорректной
+    Position position(record.size);
+    for (std::uint8_t move : record.moves) {
+        if (move >= position.cellCount() || position.winner() != 0 || position.isFull()
+            || position.cell(move) != 0) {
+            return false;
+        }
+        position.play(move);
+    }
+
+    position = Position(record.size);
+    int plies = std::min<int>(m_maxPlies, int(record.moves.size()));
+
+    for (int ply = 0; ply < plies; ++ply) {
+        // Симметричные ходы одной позиции (углы пустого поля и т.п.) копят
+        // статистику в одной записи
+        int move = record.moves[ply];
+        Key key{ position.canonicalHash(), position.canonicalMove(move) };
+        int mover = position.sideToMove();
+
+        Stats &stats = m_stats[key];
+        ++stats.games;
+        stats.points += record.result == 0 ? 1 : record.result == mover ? 2 : 0;
+
+        position.play(move);
+    }
+    ++m_games;
+    return true;
+}
+
+std::vector<OpeningBook::Entry> BookBuilder::entries(int minGames) const
+{
+    std::vector<OpeningBook::Entry> result;
+    for (const auto &item : m_stats) {
+        if (item.second.games < std::uint32_t(minGames)) continue;
+
+        OpeningBook::Entry entry = {};
+        entry.key = item.first.position;
+        entry.move = std::uint8_t(item.first.move);
+        entry.games = item.second.games;
+        entry.points = item.second.points;
+        result.push_back(entry);
+    }
+    return result;
+}
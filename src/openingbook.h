@@ -0,0 +1,90 @@
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "gameengine.h"
+#include "gamerecord.h"
+
+class QFile;
+
+// Дебютная книга: отсортированный по ключу массив записей, отображаемый
+// в память при первом обращении. Ключ - канонический (с учётом симметрий)
+// хеш позиции, ход хранится в канонической ориентации.
+//
+// Формат файла (little-endian): "TTTBOOK1", uint32 размер записи,
+// uint32 число записей, затем записи Entry.
+class OpeningBook
+{
+public:
+    struct Entry
+    {
+        std::uint64_t key;
+        std::uint32_t games;
+        std::uint32_t points; // полуочки стороны, сделавшей ход
+        std::uint8_t move;
+        std::uint8_t reserved[7];
+    };
+
+    explicit OpeningBook(const std::string &path);
+    ~OpeningBook();
+
+    // Лучший по книге ход или -1; без выделений памяти, потокобезопасно
+    int probe(const Position &position) const;
+
+    bool isLoaded() const;
+    std::size_t size() const;
+
+    static bool write(const std::string &path, std::vector<Entry> entries);
+    static OpeningBook &defaultBook();
+
+private:
+    void load() const;
+
+    std::string m_path;
+    mutable std::once_flag m_loaded;
+    mutable std::unique_ptr<QFile> m_file;
+    mutable const Entry *m_entries;
+    mutable std::size_t m_count;
+};
+
+// Накопление статистики по позициям из сыгранных партий
+class BookBuilder
+{
+public:
+    explicit BookBuilder(int maxPlies);
+
+    // Некорректные партии (занятая клетка, ход после конца) пропускаются
+    bool addGame(const GameRecord &record);
+    std::vector<OpeningBook::Entry> entries(int minGames) const;
+    std::size_t gameCount() const { return m_games; }
+
+private:
+    struct Key
+    {
+        std::uint64_t position;
+        int move;
+        bool operator==(const Key &other) const { return position == other.position && move == other.move; }
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key &key) const { return std::size_t(key.position ^ (std::uint64_t(key.move) << 57)); }
+    };
+
+    struct Stats
+    {
+        std::uint32_t games = 0;
+        std::uint32_t points = 0;
+    };
+
+    int m_maxPlies;
+    std::size_t m_games;
+    std::unordered_map<Key, Stats, KeyHash> m_stats;
+};
+
+#endif // OPENINGBOOK_H
@@ -0,0 +1,103 @@
+#include "selfplaypool.h"
+#include <QRandomGenerator>
+#include <QTimer>
+#include "engineplayer.h"
+#include "trace.h"
+
+namespace {
+
+const int RestartDelayMs = 1000;
+
+} // namespace
+
+SelfPlayPool::SelfPlayPool(const GameEngine::Config &config, int threads, QObject *parent)
+    : QObject(parent), m_config(config), m_quit(false)
+{
+    for (int i = 0; i < qMax(threads, 1); ++i) {
+        m_threads.emplace_back(&SelfPlayPool::worker, this);
+    }
+}
+
+SelfPlayPool::~SelfPlayPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit.store(true);
+        m_jobs.clear();
+    }
+    m_condition.notify_all();
+
+    for (std::thread &thread : m_threads) {
+        thread.join();
+    }
+}
+
+void SelfPlayPool::addGame(GameLogic *logic)
+{
+    m_games.append(logic);
+    m_serials.append(0);
+    startGame(m_games.size() - 1);
+}
+
+void SelfPlayPool::startGame(int game)
+{
+    GameLogic *logic = m_games[game];
+    logic->newGame();
+
+    // Случайный первый ход, иначе все партии на доске одинаковы
+    int size = logic->boardSize();
+    int cell = QRandomGenerator::global()->bounded(size * size);
+    logic->makeMove(cell / size, cell % size);
+
+    requestMove(game);
+}
+
+void SelfPlayPool::requestMove(int game)
+{
+    Job job{ game, ++m_serials[game], positionFromLogic(*m_games[game]) };
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(job);
+    }
+    m_condition.notify_one();
+}
+
+void SelfPlayPool::applyMove(int game, quint64 serial, int move)
+{
+    TRACE_SCOPE("SelfPlayPool::applyMove", "engine");
+
+    GameLogic *logic = m_games[game];
+    if (serial != m_serials[game] || move < 0) return;
+
+    int size = logic->boardSize();
+    logic->makeMove(move / size, move % size);
+
+    if (logic->gameState() == GameLogic::StateFinished) {
+        emit gameFinished(logic->winner());
+        QTimer::singleShot(RestartDelayMs, this, [this, game]() { startGame(game); });
+    } else {
+        requestMove(game);
+    }
+}
+
+void SelfPlayPool::worker()
+{
+    Trace::setThreadName("self-play");
+    GameEngine engine(m_config);
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_quit.load() || !m_jobs.empty(); });
+            if (m_quit.load()) return;
+            job = m_jobs.front();
+            m_jobs.pop_front();
+        }
+
+        GameEngine::SearchResult result = engine.search(job.position, &m_quit);
+        QMetaObject::invokeMethod(this, [this, job, result]() {
+            applyMove(job.game, job.serial, result.move);
+        }, Qt::QueuedConnection);
+    }
+}
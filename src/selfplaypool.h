@@ -0,0 +1,55 @@
+#ifndef SELFPLAYPOOL_H
+#define SELFPLAYPOOL_H
+
+#include <QObject>
+#include <QVector>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "gameengine.h"
+#include "gamelogic.h"
+
+// Пул потоков, которые разыгрывают множество партий компьютер против
+// компьютера. Сами партии (GameLogic) живут в GUI-потоке, в пул уходят
+// только копии позиций.
+class SelfPlayPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    SelfPlayPool(const GameEngine::Config &config, int threads, QObject *parent = nullptr);
+    ~SelfPlayPool() override;
+
+    void addGame(GameLogic *logic);
+
+signals:
+    void gameFinished(GameLogic::Player winner);
+
+private:
+    struct Job
+    {
+        int game;
+        quint64 serial;
+        Position position;
+    };
+
+    void startGame(int game);
+    void requestMove(int game);
+    void applyMove(int game, quint64 serial, int move);
+    void worker();
+
+    GameEngine::Config m_config;
+    QVector<GameLogic *> m_games;
+    QVector<quint64> m_serials;
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Job> m_jobs;
+    std::atomic<bool> m_quit;
+};
+
+#endif // SELFPLAYPOOL_H
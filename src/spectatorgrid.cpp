@@ -0,0 +1,178 @@
+#include "spectatorgrid.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QLinearGradient>
+#include <QtMath>
+#include <cmath>
+#include "trace.h"
+
+namespace {
+
+const int FrameIntervalMs = 33;
+const int TileMargin = 4;
+
+} // namespace
+
+SpectatorGrid::SpectatorGrid(QWidget *parent)
+    : QWidget(parent), m_frameTimer(new QTimer(this)), m_columns(1), m_tileSize(0),
+      m_xWins(0), m_oWins(0), m_draws(0)
+{
+    setMinimumSize(320, 320);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+
+    m_frameTimer->setInterval(FrameIntervalMs);
+    connect(m_frameTimer, &QTimer::timeout, this, &SpectatorGrid::onFrame);
+    m_frameTimer->start();
+}
+
+void SpectatorGrid::addGame(GameLogic *logic)
+{
+    int index = m_games.size();
+    m_games.append(logic);
+    m_dirty.append(true);
+
+    // Серии boardChanged между кадрами схлопываются в один флаг
+    connect(logic, &GameLogic::boardChanged, this, [this, index]() {
+        m_dirty[index] = true;
+    });
+
+    updateLayout();
+    updateTitle();
+    update();
+}
+
+void SpectatorGrid::addResult(GameLogic::Player winner)
+{
+    if (winner == GameLogic::PlayerX) ++m_xWins;
+    else if (winner == GameLogic::PlayerO) ++m_oWins;
+    else ++m_draws;
+    updateTitle();
+}
+
+void SpectatorGrid::updateTitle()
+{
+    setWindowTitle(QString("Наблюдение: %1 партий  X %2  O %3  ничьи %4")
+                   .arg(m_games.size()).arg(m_xWins).arg(m_oWins).arg(m_draws));
+}
+
+void SpectatorGrid::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    updateLayout();
+}
+
+void SpectatorGrid::updateLayout()
+{
+    int count = qMax(m_games.size(), 1);
+    m_columns = int(std::ceil(std::sqrt(double(count))));
+    int rows = (count + m_columns - 1) / m_columns;
+    int tileSize = qMin(width() / m_columns, height() / rows);
+    if (tileSize != m_tileSize) {
+        m_tileSize = tileSize;
+        m_glyphs.clear();
+    }
+}
+
+QRect SpectatorGrid::boardRect(int index) const
+{
+    int row = index / m_columns;
+    int col = index % m_columns;
+    return QRect(col * m_tileSize, row * m_tileSize, m_tileSize, m_tileSize)
+        .adjusted(TileMargin, TileMargin, -TileMargin, -TileMargin);
+}
+
+void SpectatorGrid::onFrame()
+{
+    for (int i = 0; i < m_games.size(); ++i) {
+        if (m_dirty[i]) {
+            m_dirty[i] = false;
+            update(boardRect(i));
+        }
+    }
+}
+
+void SpectatorGrid::paintEvent(QPaintEvent *event)
+{
+    TRACE_SCOPE("SpectatorGrid::paintEvent", "paint");
+    QPainter painter(this);
+
+    // Грязные доски приходят одним регионом; его ограничивающий
+    // прямоугольник накрыл бы доски между ними
+    const QRegion &region = event->region();
+    for (const QRect &rect : region) {
+        painter.fillRect(rect, QColor("#1e1e1e"));
+    }
+
+    for (int i = 0; i < m_games.size(); ++i) {
+        QRect rect = boardRect(i);
+        if (region.intersects(rect)) {
+            drawBoard(painter, m_games[i], rect);
+            emit boardPainted(i);
+        }
+    }
+}
+
+void SpectatorGrid::drawBoard(QPainter &painter, const GameLogic *logic, const QRect &rect)
+{
+    int size = logic->boardSize();
+    int cellSize = rect.width() / size;
+    if (cellSize <= 0) return;
+
+    QColor border = logic->gameState() == GameLogic::StateFinished ? QColor("#aaaaaa")
+                                                                   : QColor("#4a4a4a");
+    painter.fillRect(rect, QColor("#2a2a2a"));
+    painter.setPen(QPen(border, 1));
+    painter.drawRect(rect.adjusted(0, 0, -1, -1));
+
+    for (int i = 1; i < size; ++i) {
+        int offset = i * cellSize;
+        painter.drawLine(rect.left() + offset, rect.top(), rect.left() + offset, rect.top() + size * cellSize);
+        painter.drawLine(rect.left(), rect.top() + offset, rect.left() + size * cellSize, rect.top() + offset);
+    }
+
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            GameLogic::CellState cell = logic->cellState(row, col);
+            if (cell != GameLogic::CellEmpty) {
+                painter.drawPixmap(rect.left() + col * cellSize, rect.top() + row * cellSize,
+                                   glyph(cell, cellSize));
+            }
+        }
+    }
+}
+
+// Значки рисуются в физических пикселях экрана, на котором сейчас окно
+const QPixmap &SpectatorGrid::glyph(GameLogic::CellState cell, int size)
+{
+    qreal ratio = devicePixelRatioF();
+    quint64 key = (quint64(qRound(ratio * 100)) << 32) | quint64(size * 2 + (cell == GameLogic::CellX ? 0 : 1));
+    auto it = m_glyphs.find(key);
+    if (it != m_glyphs.end()) return it.value();
+
+    QPixmap pixmap(qCeil(size * ratio), qCeil(size * ratio));
+    pixmap.setDevicePixelRatio(ratio);
+    pixmap.fill(Qt::transparent);
+
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    int padding = qMax(size / 6, 1);
+    int penWidth = qMax(size / 12, 1);
+    QRect rect(0, 0, size, size);
+    QLinearGradient gradient(rect.topLeft(), rect.bottomRight());
+
+    if (cell == GameLogic::CellX) {
+        gradient.setColorAt(0, QColor("#ff6b6b"));
+        gradient.setColorAt(1, QColor("#ff4757"));
+        painter.setPen(QPen(gradient, penWidth));
+        painter.drawLine(padding, padding, size - padding, size - padding);
+        painter.drawLine(size - padding, padding, padding, size - padding);
+    } else {
+        gradient.setColorAt(0, QColor("#4a9cff"));
+        gradient.setColorAt(1, QColor("#3742fa"));
+        painter.setPen(QPen(gradient, penWidth));
+        painter.drawEllipse(rect.adjusted(padding, padding, -padding, -padding));
+    }
+    painter.end();
+
+    return m_glyphs.insert(key, pixmap).value();
+}
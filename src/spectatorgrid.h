@@ -0,0 +1,58 @@
+#ifndef SPECTATORGRID_H
+#define SPECTATORGRID_H
+
+#include <QWidget>
+#include <QHash>
+#include <QPixmap>
+#include <QTimer>
+#include <QVector>
+#include "gamelogic.h"
+
+// Сетка из множества партий в одном виджете. Изменения досок только
+// помечаются, а перерисовка грязных досок идёт пачкой по таймеру кадра.
+class SpectatorGrid : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SpectatorGrid(QWidget *parent = nullptr);
+
+    void addGame(GameLogic *logic);
+    int gameCount() const { return m_games.size(); }
+
+signals:
+    // Доска перерисована; для тестов и замеров пакетной отрисовки
+    void boardPainted(int index);
+
+public slots:
+    void addResult(GameLogic::Player winner);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+    void onFrame();
+
+private:
+    void updateLayout();
+    void drawBoard(QPainter &painter, const GameLogic *logic, const QRect &rect);
+    QRect boardRect(int index) const;
+    void updateTitle();
+    const QPixmap &glyph(GameLogic::CellState cell, int size);
+
+    QVector<GameLogic *> m_games;
+    QVector<bool> m_dirty;
+    QTimer *m_frameTimer;
+    int m_columns;
+    int m_tileSize;
+
+    // Значки текущего размера клетки; сбрасываются при смене раскладки
+    QHash<quint64, QPixmap> m_glyphs;
+
+    int m_xWins;
+    int m_oWins;
+    int m_draws;
+};
+
+#endif // SPECTATORGRID_H
@@ -0,0 +1,206 @@
+#include "tournament.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include "trace.h"
+
+double MatchStats::score() const
+{
+    int n = games();
+    return n > 0 ? (wins + 0.5 * draws) / n : 0.5;
+}
+
+double MatchStats::variance() const
+{
+    int n = games();
+    if (n == 0) return 0.0;
+
+    double s = score();
+    return (wins * (1.0 - s) * (1.0 - s)
+            + draws * (0.5 - s) * (0.5 - s)
+            + losses * s * s) / n;
+}
+
+double MatchStats::eloFromScore(double score)
+{
+    score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+double MatchStats::scoreFromElo(double elo)
+{
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+double MatchStats::elo() const
+{
+    return eloFromScore(score());
+}
+
+double MatchStats::regularizedVariance() const
+{
+    MatchStats regularized = *this;
+    ++regularized.wins;
+    ++regularized.losses;
+    return regularized.variance();
+}
+
+// Дисперсия регуляризована так же, как в llr(): иначе серия ничьих
+// даёт интервал нулевой ширины
+double MatchStats::eloError() const
+{
+    int n = games();
+    if (n == 0) return 0.0;
+
+    double deviation = 1.96 * std::sqrt(regularizedVariance() / n);
+    return (eloFromScore(score() + deviation) - eloFromScore(score() - deviation)) / 2.0;
+}
+
+// Обобщённый SPRT в нормальном приближении (как в fishtest). Дисперсию
+// считаем с одной виртуальной победой и поражением, иначе серия сплошных
+// ничьих (частый случай на больших полях) даёт нулевую дисперсию.
+double MatchStats::llr(double elo0, double elo1) const
+{
+    if (games() == 0) return 0.0;
+
+    double v = regularizedVariance();
+
+    double s0 = scoreFromElo(elo0);
+    double s1 = scoreFromElo(elo1);
+    return games() * (s1 - s0) * (2.0 * score() - s0 - s1) / (2.0 * v);
+}
+
+Tournament::Tournament(const GameEngine::Config &first, const GameEngine::Config &second,
+                       const Settings &settings)
+    : m_first(first), m_second(second), m_settings(settings), m_nextPair(0), m_stop(false),
+      m_book(nullptr)
+{
+    if (m_settings.boardSizes.empty()) {
+        m_settings.boardSizes.push_back(3);
+    }
+}
+
+double Tournament::lowerBound() const
+{
+    return std::log(m_settings.beta / (1.0 - m_settings.alpha));
+}
+
+double Tournament::upperBound() const
+{
+    return std::log((1.0 - m_settings.beta) / m_settings.alpha);
+}
+
+Position Tournament::randomOpening(int size, int plies, std::uint64_t seed,
+                                   std::vector<std::uint8_t> *moves)
+{
+    Position position(size);
+    std::mt19937_64 random(seed);
+
+    for (int ply = 0; ply < plies && !position.isFinished(); ++ply) {
+        int empty = position.cellCount() - position.moveCount();
+        int choice = int(random() % std::uint64_t(empty));
+        for (int index = 0; index < position.cellCount(); ++index) {
+            if (position.cell(index) == 0 && choice-- == 0) {
+                position.play(index);
+                if (moves) moves->push_back(std::uint8_t(index));
+                break;
+            }
+        }
+    }
+
+    return position;
+}
+
+int Tournament::playGame(Position position, GameEngine &x, GameEngine &o,
+                         const std::atomic<bool> *stop, std::vector<std::uint8_t> *moves)
+{
+    x.newGame();
+    o.newGame();
+
+    while (!position.isFinished()) {
+        GameEngine &engine = position.sideToMove() == 1 ? x : o;
+        GameEngine::SearchResult result = engine.search(position, stop);
+        if (result.move < 0) break;
+        position.play(result.move);
+        if (moves) moves->push_back(std::uint8_t(result.move));
+    }
+
+    return position.winner();
+}
+
+Tournament::Result Tournament::run(const ProgressCallback &progress)
+{
+    m_progress = progress;
+    m_result = Result();
+    m_nextPair.store(0);
+    m_stop.store(false);
+
+    int threads = m_settings.threads > 0 ? m_settings.threads
+                                         : int(std::thread::hardware_concurrency());
+    threads = std::max(threads, 1);
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i) {
+        pool.emplace_back(&Tournament::worker, this);
+    }
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+
+    if (m_result.outcome == OutcomeUnfinished && m_result.stats.games() >= m_settings.maxGames) {
+        m_result.outcome = OutcomeMaxGames;
+    }
+    return m_result;
+}
+
+void Tournament::worker()
+{
+    Trace::setThreadName("tournament");
+    GameEngine first(m_first);
+    GameEngine second(m_second);
+    first.setBook(m_book);
+    second.setBook(m_book);
+    int pairs = (m_settings.maxGames + 1) / 2;
+
+    while (!m_stop.load()) {
+        int pair = m_nextPair.fetch_add(1);
+        if (pair >= pairs) break;
+
+        int size = m_settings.boardSizes[pair % m_settings.boardSizes.size()];
+        int plies = m_settings.openingPlies >= 0 ? m_settings.openingPlies
+                                                 : (size <= 3 ? 1 : size / 2);
+        GameRecord records[2];
+        Position opening = randomOpening(size, plies, m_settings.seed * 0x9e3779b97f4a7c15ULL + pair,
+                                         &records[0].moves);
+        records[1].moves = records[0].moves;
+
+        // Одна и та же дебютная позиция играется дважды со сменой цвета;
+        // при нечётном maxGames последняя пара - одна партия
+        int games = std::min(2, m_settings.maxGames - 2 * pair);
+        Trace::Scope scope("Tournament::pair", "tournament", "pair", pair);
+        records[0].result = playGame(opening, first, second, &m_stop, &records[0].moves);
+        if (games > 1) records[1].result = playGame(opening, second, first, &m_stop, &records[1].moves);
+        if (m_stop.load()) break;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int game = 0; game < games; ++game) {
+            int firstSide = game == 0 ? 1 : 2;
+            if (records[game].result == 0) ++m_result.stats.draws;
+            else if (records[game].result == firstSide) ++m_result.stats.wins;
+            else ++m_result.stats.losses;
+
+            records[game].size = size;
+            if (m_gameCallback) m_gameCallback(records[game]);
+        }
+
+        if (m_settings.sprt) {
+            m_result.llr = m_result.stats.llr(m_settings.elo0, m_settings.elo1);
+            if (m_result.llr >= upperBound()) m_result.outcome = OutcomeAcceptH1;
+            else if (m_result.llr <= lowerBound()) m_result.outcome = OutcomeAcceptH0;
+        }
+
+        if (m_progress) m_progress(m_result);
+        if (m_result.outcome != OutcomeUnfinished) m_stop.store(true);
+    }
+}
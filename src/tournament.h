@@ -0,0 +1,100 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "gameengine.h"
+#include "gamerecord.h"
+
+// Счёт матча с точки зрения первого движка
+struct MatchStats
+{
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+
+    int games() const { return wins + draws + losses; }
+    double score() const;
+    double variance() const;
+
+    double elo() const;
+    double eloError() const; // полуширина 95% доверительного интервала
+    double llr(double elo0, double elo1) const;
+    // Дисперсия с одной виртуальной победой и поражением
+    double regularizedVariance() const;
+
+    static double eloFromScore(double score);
+    static double scoreFromElo(double elo);
+};
+
+class Tournament
+{
+public:
+    enum Outcome { OutcomeUnfinished, OutcomeMaxGames, OutcomeAcceptH0, OutcomeAcceptH1 };
+
+    struct Settings
+    {
+        std::vector<int> boardSizes = { 3, 4, 5 };
+        int maxGames = 1000;   // при нечётном числе последняя пара неполная
+        int threads = 0;       // 0 - по числу ядер
+        int openingPlies = -1; // -1 - в зависимости от размера поля
+        std::uint64_t seed = 1;
+
+        bool sprt = true;
+        double elo0 = 0.0;
+        double elo1 = 10.0;
+        double alpha = 0.05;
+        double beta = 0.05;
+    };
+
+    struct Result
+    {
+        MatchStats stats;
+        Outcome outcome = OutcomeUnfinished;
+        double llr = 0.0;
+    };
+
+    typedef std::function<void(const Result &)> ProgressCallback;
+    typedef std::function<void(const GameRecord &)> GameCallback;
+
+    Tournament(const GameEngine::Config &first, const GameEngine::Config &second,
+               const Settings &settings);
+
+    Result run(const ProgressCallback &progress = ProgressCallback());
+    void stop() { m_stop.store(true); }
+
+    // Вызывается под мьютексом турнира для каждой сыгранной партии
+    void setGameCallback(const GameCallback &callback) { m_gameCallback = callback; }
+    // Дебютная книга для обоих движков
+    void setBook(const OpeningBook *book) { m_book = book; }
+
+    double lowerBound() const;
+    double upperBound() const;
+
+    // Партия из заданной позиции; результат: 1 - победа X, 2 - победа O, 0 - ничья
+    static int playGame(Position position, GameEngine &x, GameEngine &o,
+                        const std::atomic<bool> *stop = nullptr,
+                        std::vector<std::uint8_t> *moves = nullptr);
+    static Position randomOpening(int size, int plies, std::uint64_t seed,
+                                  std::vector<std::uint8_t> *moves = nullptr);
+
+private:
+    void worker();
+
+    GameEngine::Config m_first;
+    GameEngine::Config m_second;
+    Settings m_settings;
+
+    std::atomic<int> m_nextPair;
+    std::atomic<bool> m_stop;
+    std::mutex m_mutex;
+    ProgressCallback m_progress;
+    GameCallback m_gameCallback;
+    const OpeningBook *m_book;
+    Result m_result;
+};
+
+#endif // TOURNAMENT_H
@@ -0,0 +1,238 @@
+#include "trace.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace {
+
+std::atomic<bool> g_enabled(false);
+
+namespace {
+
+struct Event
+{
+    const char *name;
+    const char *category;
+    const char *argName;
+    std::int64_t argValue;
+    std::uint64_t start;
+    std::uint64_t end; // 0 - мгновенное событие
+};
+
+enum { ChunkSize = 1024, MaxChunks = 1024 };
+
+// Пишет только поток-владелец; читатель видит события до count (acquire)
+struct ThreadBuffer
+{
+    int tid = 0;
+    std::string name;
+    std::atomic<Event *> chunks[MaxChunks] = {};
+    std::atomic<std::size_t> count{0};
+
+    ~ThreadBuffer()
+    {
+        for (auto &chunk : chunks) {
+            delete[] chunk.load();
+        }
+    }
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer *> free; // буферы завершившихся потоков
+    std::uint64_t origin = 0;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+// Буферы живут до конца процесса, чтобы события завершившихся потоков
+// тоже попали в выгрузку. Движок и анализ запускают поток на каждый ход,
+// поэтому при выходе потока буфер возвращается в free и достаётся новому
+// потоку с тем же именем: буферов и строк в выгрузке не больше, чем
+// одновременно живущих потоков каждого имени.
+struct BufferOwner
+{
+    ThreadBuffer *buffer = nullptr;
+
+    ~BufferOwner()
+    {
+        if (!buffer) return;
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.free.push_back(buffer);
+    }
+};
+
+BufferOwner &bufferOwner()
+{
+    thread_local BufferOwner owner;
+    return owner;
+}
+
+// Вызывается под мьютексом реестра
+ThreadBuffer *takeFree(Registry &r, const std::string &name)
+{
+    for (auto it = r.free.begin(); it != r.free.end(); ++it) {
+        if ((*it)->name == name) {
+            ThreadBuffer *buffer = *it;
+            r.free.erase(it);
+            return buffer;
+        }
+    }
+    return nullptr;
+}
+
+ThreadBuffer *create(Registry &r, const std::string &name)
+{
+    r.buffers.emplace_back(new ThreadBuffer());
+    ThreadBuffer *buffer = r.buffers.back().get();
+    buffer->tid = int(r.buffers.size());
+    buffer->name = name;
+    return buffer;
+}
+
+ThreadBuffer &threadBuffer()
+{
+    BufferOwner &owner = bufferOwner();
+    if (!owner.buffer) {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        owner.buffer = takeFree(r, std::string());
+        if (!owner.buffer) owner.buffer = create(r, std::string());
+    }
+    return *owner.buffer;
+}
+
+void append(const Event &event)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    std::size_t index = buffer.count.load(std::memory_order_relaxed);
+    std::size_t chunkIndex = index / ChunkSize;
+    if (chunkIndex >= MaxChunks) return;
+
+    Event *chunk = buffer.chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new Event[ChunkSize];
+        buffer.chunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+
+    chunk[index % ChunkSize] = event;
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+} // namespace
+
+std::uint64_t nowNs()
+{
+    using namespace std::chrono;
+    return std::uint64_t(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+void start()
+{
+    Registry &r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (r.origin == 0) r.origin = nowNs();
+    }
+    g_enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop()
+{
+    g_enabled.store(false, std::memory_order_relaxed);
+}
+
+void setThreadName(const char *name)
+{
+    // Без трассировки буфер потоку не заводим
+    if (!enabled()) return;
+
+    BufferOwner &owner = bufferOwner();
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    ThreadBuffer *previous = owner.buffer;
+    if (previous && previous->name == name) return;
+
+    // Поток мог записать события до того, как получил имя: они остаются в
+    // безымянной строке, а поток переходит на буфер своего имени. Пустой
+    // буфер просто переименовываем, если свободного с таким именем нет.
+    owner.buffer = takeFree(r, name);
+    if (!owner.buffer && previous && previous->count.load(std::memory_order_relaxed) == 0) {
+        owner.buffer = previous;
+        owner.buffer->name = name;
+        previous = nullptr;
+    }
+    if (!owner.buffer) owner.buffer = create(r, name);
+    if (previous) r.free.push_back(previous);
+}
+
+void complete(const char *name, const char *category, std::uint64_t startNs, std::uint64_t endNs,
+              const char *argName, std::int64_t argValue)
+{
+    append(Event{ name, category, argName, argValue, startNs, endNs });
+}
+
+void instant(const char *name, const char *category)
+{
+    if (enabled()) {
+        std::uint64_t now = nowNs();
+        append(Event{ name, category, nullptr, 0, now, 0 });
+    }
+}
+
+bool writeChromeTrace(const std::string &path)
+{
+    FILE *file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const char *separator = "";
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (const auto &buffer : r.buffers) {
+        if (!buffer->name.empty()) {
+            std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                         "\"args\":{\"name\":\"%s\"}}", separator, buffer->tid, buffer->name.c_str());
+            separator = ",\n";
+        }
+
+        std::size_t count = buffer->count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; ++i) {
+            const Event *chunk = buffer->chunks[i / ChunkSize].load(std::memory_order_acquire);
+            const Event &event = chunk[i % ChunkSize];
+            double ts = (double(event.start) - double(r.origin)) / 1000.0;
+
+            if (event.end == 0) {
+                std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\","
+                             "\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                             separator, event.name, event.category, ts, buffer->tid);
+            } else {
+                std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+                             "\"dur\":%.3f,\"pid\":1,\"tid\":%d",
+                             separator, event.name, event.category, ts,
+                             (event.end - event.start) / 1000.0, buffer->tid);
+                if (event.argName) {
+                    std::fprintf(file, ",\"args\":{\"%s\":%lld}", event.argName,
+                                 static_cast<long long>(event.argValue));
+                }
+                std::fprintf(file, "}");
+            }
+            separator = ",\n";
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+
+    return std::fclose(file) == 0;
+}
+
+} // namespace Trace
@@ -0,0 +1,61 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Трассировка в формате Chrome Trace Event (chrome://tracing, Perfetto).
+// У каждого потока свой буфер из блоков; запись события не берёт
+// блокировок, мьютекс нужен только при первой записи потока, при его
+// завершении и при выгрузке. Буфер завершившегося потока достаётся
+// новому потоку с тем же именем и продолжает его строку в выгрузке.
+namespace Trace {
+
+extern std::atomic<bool> g_enabled;
+
+inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+void start();
+void stop();
+
+void setThreadName(const char *name);
+void complete(const char *name, const char *category, std::uint64_t startNs, std::uint64_t endNs,
+              const char *argName = nullptr, std::int64_t argValue = 0);
+void instant(const char *name, const char *category);
+
+bool writeChromeTrace(const std::string &path);
+
+std::uint64_t nowNs();
+
+class Scope
+{
+public:
+    Scope(const char *name, const char *category, const char *argName = nullptr,
+          std::int64_t argValue = 0)
+        : m_name(name), m_category(category), m_argName(argName), m_argValue(argValue),
+          m_start(enabled() ? nowNs() : 0)
+    {
+    }
+
+    ~Scope()
+    {
+        if (m_start != 0) {
+            complete(m_name, m_category, m_start, nowNs(), m_argName, m_argValue);
+        }
+    }
+
+private:
+    const char *m_name;
+    const char *m_category;
+    const char *m_argName;
+    std::int64_t m_argValue;
+    std::uint64_t m_start;
+};
+
+} // namespace Trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name, category) Trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name, category)
+
+#endif // TRACE_H
@@ -8,6 +8,7 @@ class TestGameBoard : public QObject
 
 private slots:
     void testGameBoardCreation();
+    void testMoveDiscardsHeatmap();
 };
 
 void TestGameBoard::testGameBoardCreation()
@@ -19,5 +20,24 @@ void TestGameBoard::testGameBoardCreation()
     QVERIFY(board.sizeHint().isValid());
 }
 
+void TestGameBoard::testMoveDiscardsHeatmap()
+{
+    GameBoard board;
+    GameLogic logic;
+    board.setGameLogic(&logic);
+    board.setHeatmapVisible(true);
+
+    board.setHeatmap(QVector<int>(9, 50));
+    QVERIFY(board.hasHeatmap());
+
+    // Оценки были для X; после хода они неверны для O
+    logic.makeMove(1, 1);
+    QVERIFY(!board.hasHeatmap());
+
+    board.setHeatmap(QVector<int>(9, -50));
+    logic.newGame();
+    QVERIFY(!board.hasHeatmap());
+}
+
 QTEST_MAIN(TestGameBoard)
 #include "test_gameboard.moc"
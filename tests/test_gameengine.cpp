@@ -0,0 +1,170 @@
+#include <QtTest>
+#include "gameengine.h"
+
+class TestGameEngine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testPositionPlayUndo();
+    void testPositionWinner();
+    void testPositionDrawn();
+    void testFindsWinningMove();
+    void testBlocksOpponent();
+    void testPerfectPlayDraws();
+    void testStopFlag();
+    void testPonderReusesTable();
+    void testAnalyse();
+};
+
+void TestGameEngine::testPositionPlayUndo()
+{
+    Position position(4);
+    std::uint64_t hash = position.hash();
+
+    position.play(5);
+    QCOMPARE(position.cell(1, 1), 1);
+    QCOMPARE(position.sideToMove(), 2);
+    QCOMPARE(position.moveCount(), 1);
+    QVERIFY(position.hash() != hash);
+
+    position.undo(5);
+    QCOMPARE(position.cell(1, 1), 0);
+    QCOMPARE(position.sideToMove(), 1);
+    QCOMPARE(position.moveCount(), 0);
+    QCOMPARE(position.hash(), hash);
+}
+
+void TestGameEngine::testPositionWinner()
+{
+    Position position(3);
+    position.play(0); // X
+    position.play(3); // O
+    position.play(1); // X
+    position.play(4); // O
+    QCOMPARE(position.winner(), 0);
+
+    position.play(2); // X - победа
+    QCOMPARE(position.winner(), 1);
+    QVERIFY(position.isFinished());
+
+    position.undo(2);
+    QCOMPARE(position.winner(), 0);
+}
+
+void TestGameEngine::testPositionDrawn()
+{
+    Position position(3);
+    const int moves[] = { 0, 1, 2, 4, 3, 5, 7, 6 };
+    for (int move : moves) {
+        position.play(move);
+    }
+
+    // Поле не заполнено, но ни одна линия уже не может быть собрана
+    QVERIFY(!position.isFull());
+    QVERIFY(position.isDrawn());
+}
+
+void TestGameEngine::testFindsWinningMove()
+{
+    Position position(3);
+    position.play(0); // X
+    position.play(3); // O
+    position.play(1); // X
+    position.play(4); // O
+
+    GameEngine engine;
+    GameEngine::SearchResult result = engine.search(position);
+    QCOMPARE(result.move, 2);
+    QVERIFY(result.score >= GameEngine::MateThreshold);
+}
+
+void TestGameEngine::testBlocksOpponent()
+{
+    Position position(4);
+    position.play(0);  // X
+    position.play(5);  // O
+    position.play(1);  // X
+    position.play(10); // O
+    position.play(2);  // X
+
+    GameEngine engine;
+    QCOMPARE(engine.search(position).move, 3);
+}
+
+void TestGameEngine::testPerfectPlayDraws()
+{
+    Position position(3);
+    GameEngine engine;
+
+    while (!position.isFinished()) {
+        GameEngine::SearchResult result = engine.search(position);
+        QVERIFY(result.move >= 0);
+        position.play(result.move);
+    }
+
+    QCOMPARE(position.winner(), 0);
+}
+
+void TestGameEngine::testStopFlag()
+{
+    GameEngine::Config config;
+    config.timeLimitMs = 0;
+    GameEngine engine(config);
+
+    std::atomic<bool> stop(true);
+    GameEngine::SearchResult result = engine.search(Position(10), &stop);
+
+    // Даже прерванный поиск возвращает допустимый ход
+    QVERIFY(result.move >= 0);
+    QVERIFY(result.depth <= 1);
+}
+
+void TestGameEngine::testPonderReusesTable()
+{
+    GameEngine::Config config;
+    config.maxDepth = 5;
+    config.timeLimitMs = 0;
+
+    Position position(5);
+    position.play(12);
+
+    GameEngine pondering(config);
+    std::atomic<bool> stop(false);
+    GameEngine::SearchResult predicted = pondering.ponder(position, &stop);
+    QVERIFY(predicted.move >= 0);
+    QCOMPARE(position.cell(predicted.move), 0);
+
+    // Соперник ответил предсказанным ходом
+    position.play(predicted.move);
+    GameEngine fresh(config);
+    GameEngine::SearchResult cold = fresh.search(position);
+    GameEngine::SearchResult warm = pondering.search(position);
+
+    QCOMPARE(warm.depth, cold.depth);
+    QCOMPARE(warm.move, cold.move);
+    QVERIFY(warm.nodes * 10 < cold.nodes);
+}
+
+void TestGameEngine::testAnalyse()
+{
+    Position position(3);
+    position.play(0); // X
+    position.play(3); // O
+    position.play(1); // X
+    position.play(4); // O
+
+    GameEngine engine;
+    std::vector<int> scores;
+    std::atomic<bool> stop(false);
+    QVERIFY(engine.analyse(position, 3, scores, &stop));
+    QCOMPARE(int(scores.size()), 9);
+
+    // Выигрыш сразу, остальные ходы проигрывают из-за угрозы O по второй строке
+    QVERIFY(scores[2] >= GameEngine::MateThreshold);
+    QVERIFY(scores[6] <= -GameEngine::MateThreshold);
+    QVERIFY(scores[8] <= -GameEngine::MateThreshold);
+}
+
+QTEST_APPLESS_MAIN(TestGameEngine)
+#include "test_gameengine.moc"
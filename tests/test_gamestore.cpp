@@ -0,0 +1,251 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <map>
+#include "gamestore.h"
+
+class TestGameStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEmptyStore();
+    void testOpenings();
+    void testSizeStats();
+    void testContinuations();
+    void testRejectsInvalidGames();
+    void testFullBoardDraw();
+    void testContinuationsMatchRecords();
+};
+
+namespace {
+
+GameRecord makeRecord(int size, int result, std::vector<std::uint8_t> moves)
+{
+    GameRecord record;
+    record.size = size;
+    record.result = result;
+    record.moves = moves;
+    return record;
+}
+
+// Маленькие блоки, чтобы запросы проходили через несколько блоков и потоков
+void writeSample(const std::string &directory)
+{
+    GameStoreWriter writer(directory, 4, 3);
+    QVERIFY(writer.isOpen());
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(writer.add(makeRecord(3, 1, { 0, 1, 4, 2, 8 })));
+        QVERIFY(writer.add(makeRecord(3, 0, { 4, 0, 8, 2, 1, 7, 6, 3 })));
+        QVERIFY(writer.add(makeRecord(4, 2, { 8, 0, 2, 5, 3, 10, 12, 15 })));
+    }
+    QVERIFY(writer.add(makeRecord(3, 2, { 8, 4, 1, 0 })));
+    QVERIFY(writer.finish());
+    QCOMPARE(int(writer.gameCount()), 16);
+}
+
+} // namespace
+
+void TestGameStore::testEmptyStore()
+{
+    QTemporaryDir dir;
+    std::string path = dir.filePath("store").toStdString();
+    {
+        GameStoreWriter writer(path);
+        QVERIFY(writer.finish());
+    }
+
+    GameStore store(path);
+    QVERIFY(store.isOpen());
+    QCOMPARE(int(store.gameCount()), 0);
+    QVERIFY(store.openings(3).empty());
+    QVERIFY(store.sizeStats().empty());
+
+    GameStore missing(dir.filePath("missing").toStdString());
+    QVERIFY(!missing.isOpen());
+}
+
+void TestGameStore::testOpenings()
+{
+    QTemporaryDir dir;
+    std::string path = dir.filePath("store").toStdString();
+    writeSample(path);
+
+    GameStore store(path);
+    store.setThreads(3);
+    std::vector<GameStore::MoveStats> openings = store.openings(3);
+    QCOMPARE(int(openings.size()), 3);
+
+    QCOMPARE(openings[0].cell, 0);
+    QCOMPARE(int(openings[0].outcomes.games), 5);
+    QCOMPARE(int(openings[0].outcomes.xWins), 5);
+    QCOMPARE(openings[1].cell, 4);
+    QCOMPARE(int(openings[1].outcomes.draws), 5);
+    QCOMPARE(openings[2].cell, 8);
+    QCOMPARE(int(openings[2].outcomes.oWins), 1);
+
+    std::vector<GameStore::MoveStats> large = store.openings(4);
+    QCOMPARE(int(large.size()), 1);
+    QCOMPARE(large[0].cell, 8);
+    QCOMPARE(int(large[0].outcomes.oWins), 5);
+}
+
+void TestGameStore::testSizeStats()
+{
+    QTemporaryDir dir;
+    std::string path = dir.filePath("store").toStdString();
+    writeSample(path);
+
+    GameStore store(path);
+    std::vector<GameStore::SizeStats> stats = store.sizeStats();
+    QCOMPARE(int(stats.size()), 2);
+
+    QCOMPARE(stats[0].size, 3);
+    QCOMPARE(int(stats[0].outcomes.games), 11);
+    QCOMPARE(int(stats[0].lengths[4]), 1);
+    QCOMPARE(int(stats[0].lengths[5]), 5);
+    QCOMPARE(int(stats[0].lengths[8]), 5);
+
+    QCOMPARE(stats[1].size, 4);
+    QCOMPARE(int(stats[1].lengths[8]), 5);
+
+    std::vector<GameStore::SizeStats> filtered = store.sizeStats(4);
+    QCOMPARE(int(filtered.size()), 1);
+    QCOMPARE(int(filtered[0].outcomes.games), 5);
+}
+
+void TestGameStore::testContinuations()
+{
+    QTemporaryDir dir;
+    std::string path = dir.filePath("store").toStdString();
+    writeSample(path);
+    GameStore store(path);
+
+    // Все угловые первые ходы - одна позиция: ответы (0,1) из партий с X в
+    // углу 0 в позиции с X в углу 2 соответствуют клетке 1 или 5
+    Position position(3);
+    position.play(2);
+    std::vector<GameStore::MoveStats> moves = store.continuations(position);
+    QCOMPARE(int(moves.size()), 2);
+    for (const GameStore::MoveStats &stats : moves) {
+        if (stats.cell == 4) {
+            QCOMPARE(int(stats.outcomes.oWins), 1);
+        } else {
+            QVERIFY(stats.cell == 1 || stats.cell == 5);
+            QCOMPARE(int(stats.outcomes.xWins), 5);
+        }
+    }
+
+    Position corner(3);
+    corner.play(8);
+    int total = 0;
+    for (const GameStore::MoveStats &stats : store.continuations(corner)) {
+        total += int(stats.outcomes.games);
+    }
+    QCOMPARE(total, 6);
+
+    // Глубже словаря позиции не кодируются
+    Position deep(3);
+    for (int move : { 4, 0, 8, 2 }) {
+        deep.play(move);
+    }
+    QVERIFY(store.continuations(deep).empty());
+}
+
+void TestGameStore::testRejectsInvalidGames()
+{
+    QTemporaryDir dir;
+    GameStoreWriter writer(dir.filePath("store").toStdString());
+    QVERIFY(!writer.add(makeRecord(3, 1, { 0, 0 })));
+    QVERIFY(!writer.add(makeRecord(3, 1, { 0, 9 })));
+    QVERIFY(!writer.add(makeRecord(3, 1, { 0, 1, 3, 2, 6, 5 })));
+    QVERIFY(!writer.add(makeRecord(11, 0, {})));
+    QVERIFY(writer.add(makeRecord(3, 0, {})));
+    QVERIFY(writer.finish());
+    QCOMPARE(int(writer.gameCount()), 1);
+    QCOMPARE(int(writer.moveCount()), 0);
+}
+
+void TestGameStore::testFullBoardDraw()
+{
+    // Ничья видна уже после 8-го хода, но партия доиграна до полного поля
+    QTemporaryDir dir;
+    std::string path = dir.filePath("store").toStdString();
+    {
+        GameStoreWriter writer(path);
+        QVERIFY(writer.add(makeRecord(3, 0, { 0, 1, 2, 4, 3, 5, 7, 6, 8 })));
+        QVERIFY(writer.finish());
+        QCOMPARE(int(writer.moveCount()), 9);
+    }
+
+    GameStore store(path);
+    QVERIFY(store.isOpen());
+    std::vector<GameStore::SizeStats> stats = store.sizeStats(3);
+    QCOMPARE(int(stats.size()), 1);
+    QCOMPARE(int(stats[0].outcomes.draws), 1);
+    QCOMPARE(int(stats[0].lengths[9]), 1);
+}
+
+void TestGameStore::testContinuationsMatchRecords()
+{
+    // Случайные партии двух размеров вперемешку: продолжения позиций первых
+    // ходов сверяются с прямым подсчётом по записям
+    std::vector<GameRecord> records;
+    std::uint32_t seed = 12345;
+    for (int i = 0; i < 300; ++i) {
+        int size = i % 3 == 0 ? 4 : 3;
+        Position position(size);
+        GameRecord record = makeRecord(size, 0, {});
+        while (position.winner() == 0 && !position.isFull()) {
+            int move;
+            do {
+                seed = seed * 1103515245u + 12345u;
+                move = int((seed >> 16) % std::uint32_t(position.cellCount()));
+            } while (position.cell(move) != 0);
+            position.play(move);
+            record.moves.push_back(std::uint8_t(move));
+        }
+        record.result = position.winner();
+        records.push_back(record);
+    }
+
+    const int plies = 3;
+    QTemporaryDir dir;
+    std::string path = dir.filePath("store").toStdString();
+    {
+        GameStoreWriter writer(path, plies, 7);
+        for (const GameRecord &record : records) {
+            QVERIFY(writer.add(record));
+        }
+        QVERIFY(writer.finish());
+    }
+    GameStore store(path);
+    QVERIFY(store.isOpen());
+    store.setThreads(2);
+
+    for (std::size_t i = 0; i < 30; ++i) {
+        Position query(records[i].size);
+        for (int ply = 0; ply < plies; ++ply) {
+            std::map<int, std::uint64_t> expected;
+            for (const GameRecord &record : records) {
+                Position position(record.size);
+                for (int p = 0; p < plies && p < int(record.moves.size()); ++p) {
+                    if (position.canonicalHash() == query.canonicalHash()) {
+                        ++expected[position.canonicalMove(record.moves[std::size_t(p)])];
+                    }
+                    position.play(record.moves[std::size_t(p)]);
+                }
+            }
+
+            std::map<int, std::uint64_t> actual;
+            for (const GameStore::MoveStats &stats : store.continuations(query)) {
+                actual[query.canonicalMove(stats.cell)] += stats.outcomes.games;
+            }
+            QVERIFY(actual == expected);
+            query.play(records[i].moves[std::size_t(ply)]);
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(TestGameStore)
+
+#include "test_gamestore.moc"
@@ -0,0 +1,84 @@
+#include <QtTest>
+#include "metrics.h"
+
+class TestMetrics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testBucketBounds();
+    void testQuantile();
+    void testDisabledRecordsNothing();
+    void testPrometheusText();
+};
+
+void TestMetrics::testBucketBounds()
+{
+    for (std::uint64_t value : { 0ULL, 1ULL, 7ULL, 8ULL, 15ULL, 16ULL, 1000ULL, 123456789ULL, ~0ULL }) {
+        int index = Histogram::bucketIndex(value);
+        QVERIFY(index >= 0 && index < Histogram::BucketCount);
+        QVERIFY(Histogram::bucketUpperBound(index) >= value);
+        if (index > 0) {
+            QVERIFY(Histogram::bucketUpperBound(index - 1) < value);
+        }
+    }
+}
+
+void TestMetrics::testQuantile()
+{
+    Histogram histogram;
+    for (std::uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+
+    QCOMPARE(histogram.count(), std::uint64_t(1000));
+    QCOMPARE(histogram.max(), std::uint64_t(1000));
+    QCOMPARE(histogram.sum(), std::uint64_t(500500));
+
+    // Относительная погрешность не больше 1/8
+    std::uint64_t median = histogram.quantile(0.5);
+    QVERIFY(median >= 500 && median <= 500 + 500 / 8);
+    QCOMPARE(histogram.quantile(1.0), std::uint64_t(1000));
+}
+
+void TestMetrics::testDisabledRecordsNothing()
+{
+    Metrics::reset();
+    Metrics::setEnabled(false);
+    {
+        Metrics::ScopedTimer timer(Metrics::MakeMoveNs);
+    }
+    Metrics::add(Metrics::Moves);
+    QCOMPARE(Metrics::histogram(Metrics::MakeMoveNs).count(), std::uint64_t(0));
+    QCOMPARE(Metrics::counter(Metrics::Moves), std::uint64_t(0));
+
+    Metrics::setEnabled(true);
+    {
+        Metrics::ScopedTimer timer(Metrics::MakeMoveNs);
+    }
+    Metrics::add(Metrics::Moves);
+    Metrics::setEnabled(false);
+    QCOMPARE(Metrics::histogram(Metrics::MakeMoveNs).count(), std::uint64_t(1));
+    QCOMPARE(Metrics::counter(Metrics::Moves), std::uint64_t(1));
+}
+
+void TestMetrics::testPrometheusText()
+{
+    Metrics::reset();
+    Metrics::setEnabled(true);
+    Metrics::add(Metrics::Moves, 3);
+    Metrics::record(Metrics::SearchDepth, 5);
+    Metrics::record(Metrics::SearchDepth, 7);
+    Metrics::setEnabled(false);
+
+    QString text = QString::fromStdString(Metrics::prometheusText());
+    QVERIFY(text.contains("# TYPE tictactoe_moves_total counter\n"));
+    QVERIFY(text.contains("tictactoe_moves_total 3\n"));
+    QVERIFY(text.contains("tictactoe_search_depth_bucket{le=\"5\"} 1\n"));
+    QVERIFY(text.contains("tictactoe_search_depth_bucket{le=\"7\"} 2\n"));
+    QVERIFY(text.contains("tictactoe_search_depth_bucket{le=\"+Inf\"} 2\n"));
+    QVERIFY(text.contains("tictactoe_search_depth_sum 12\n"));
+}
+
+QTEST_APPLESS_MAIN(TestMetrics)
+#include "test_metrics.moc"
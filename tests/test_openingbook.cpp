@@ -0,0 +1,166 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <sstream>
+#include "openingbook.h"
+
+class TestOpeningBook : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testGameRecordRoundTrip();
+    void testCanonicalHash();
+    void testProbeSymmetricPosition();
+    void testMissingBook();
+    void testBuilderRejectsInvalidGame();
+    void testBuilderMergesSymmetricMoves();
+};
+
+void TestOpeningBook::testGameRecordRoundTrip()
+{
+    GameRecord record;
+    record.size = 4;
+    record.result = 2;
+    record.moves = { 5, 0, 10, 15 };
+
+    std::stringstream stream;
+    writeGameRecord(stream, record);
+    stream << "garbage line\n";
+    writeGameRecord(stream, record);
+
+    GameRecord read;
+    QVERIFY(readGameRecord(stream, read));
+    QCOMPARE(read.size, 4);
+    QCOMPARE(read.result, 2);
+    QVERIFY(read.moves == record.moves);
+    QVERIFY(readGameRecord(stream, read));
+    QVERIFY(!readGameRecord(stream, read));
+}
+
+void TestOpeningBook::testCanonicalHash()
+{
+    // Угловой ход в любой угол - одна и та же каноническая позиция
+    std::uint64_t hashes[4];
+    const int corners[4] = { 0, 2, 6, 8 };
+    for (int i = 0; i < 4; ++i) {
+        Position position(3);
+        position.play(corners[i]);
+        hashes[i] = position.canonicalHash();
+    }
+    for (int i = 1; i < 4; ++i) {
+        QCOMPARE(hashes[i], hashes[0]);
+    }
+
+    Position center(3);
+    center.play(4);
+    QVERIFY(center.canonicalHash() != hashes[0]);
+}
+
+void TestOpeningBook::testProbeSymmetricPosition()
+{
+    // X в углу 0, лучший ответ O - центр; книга строится по этой партии
+    GameRecord record;
+    record.size = 3;
+    record.result = 0;
+    record.moves = { 0, 4, 8, 1, 7, 6, 2, 5, 3 };
+
+    BookBuilder builder(4);
+    for (int i = 0; i < 3; ++i) {
+        builder.addGame(record);
+    }
+    QCOMPARE(int(builder.gameCount()), 3);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    std::string path = dir.filePath("book.bin").toStdString();
+    QVERIFY(OpeningBook::write(path, builder.entries(2)));
+
+    OpeningBook book(path);
+    QVERIFY(book.isLoaded());
+    QCOMPARE(int(book.size()), 4);
+
+    // На пустом поле все углы - одна запись с наименьшим индексом
+    QCOMPARE(book.probe(Position(3)), 0);
+
+    // Отражённая позиция: X в углу 8, ответ по книге тот же - центр
+    Position mirrored(3);
+    mirrored.play(8);
+    QCOMPARE(book.probe(mirrored), 4);
+
+    // X в углу 2, O в центре: ход книги 8 переходит в угол 6
+    Position rotated(3);
+    rotated.play(2);
+    rotated.play(4);
+    QCOMPARE(book.probe(rotated), 6);
+
+    Position unknown(3);
+    unknown.play(1);
+    QCOMPARE(book.probe(unknown), -1);
+}
+
+void TestOpeningBook::testMissingBook()
+{
+    OpeningBook book("no-such-book.bin");
+    QVERIFY(!book.isLoaded());
+    QCOMPARE(book.probe(Position(3)), -1);
+}
+
+void TestOpeningBook::testBuilderRejectsInvalidGame()
+{
+    // Начало партии корректно, ошибка только на пятом ходу
+    GameRecord invalid;
+    invalid.size = 3;
+    invalid.result = 1;
+    invalid.moves = { 0, 4, 8, 1, 4 };
+
+    GameRecord afterWin;
+    afterWin.size = 3;
+    afterWin.result = 1;
+    afterWin.moves = { 0, 3, 1, 4, 2, 5 };
+
+    BookBuilder builder(4);
+    QVERIFY(!builder.addGame(invalid));
+    QVERIFY(!builder.addGame(afterWin));
+    QCOMPARE(int(builder.gameCount()), 0);
+    QVERIFY(builder.entries(1).empty());
+
+    // Ничья на полном поле - обычная партия
+    GameRecord draw;
+    draw.size = 3;
+    draw.result = 0;
+    draw.moves = { 0, 1, 2, 4, 3, 5, 7, 6, 8 };
+    QVERIFY(builder.addGame(draw));
+    QCOMPARE(int(builder.gameCount()), 1);
+    QCOMPARE(int(builder.entries(1).size()), 4);
+}
+
+void TestOpeningBook::testBuilderMergesSymmetricMoves()
+{
+    // Партии с первым ходом в каждый из углов - одна запись на 12 партий
+    BookBuilder builder(1);
+    const int corners[4] = { 0, 2, 6, 8 };
+    for (int i = 0; i < 12; ++i) {
+        GameRecord record;
+        record.size = 3;
+        record.result = 1;
+        record.moves = { std::uint8_t(corners[i % 4]), 4 };
+        QVERIFY(builder.addGame(record));
+    }
+
+    std::vector<OpeningBook::Entry> entries = builder.entries(4);
+    QCOMPARE(int(entries.size()), 1);
+    QCOMPARE(int(entries[0].games), 12);
+    QCOMPARE(int(entries[0].move), 0);
+    QCOMPARE(entries[0].key, Position(3).canonicalHash());
+
+    // X в углу 0 - позиция симметрична относительно диагонали:
+    // ходы 1 и 3 равноценны, 5 - нет
+    Position corner(3);
+    corner.play(0);
+    QCOMPARE(corner.canonicalMove(1), corner.canonicalMove(3));
+    QVERIFY(corner.canonicalMove(1) != corner.canonicalMove(5));
+}
+
+QTEST_APPLESS_MAIN(TestOpeningBook)
+
+#include "test_openingbook.moc"
@@ -0,0 +1,85 @@
+#include <QtTest>
+#include <QSet>
+#include "gamelogic.h"
+#include "selfplaypool.h"
+#include "spectatorgrid.h"
+
+class TestSpectatorGrid : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testDirtyBoardsBatched();
+    void testPoolResultsInTitle();
+};
+
+void TestSpectatorGrid::testDirtyBoardsBatched()
+{
+    SpectatorGrid grid;
+    QVector<GameLogic *> games;
+    for (int i = 0; i < 16; ++i) {
+        GameLogic *logic = new GameLogic(&grid);
+        games.append(logic);
+        grid.addGame(logic);
+    }
+
+    QSignalSpy painted(&grid, &SpectatorGrid::boardPainted);
+    grid.resize(400, 400);
+    grid.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&grid));
+
+    // Первый кадр рисует все доски; ждём, пока сетка успокоится
+    QTRY_VERIFY(painted.count() >= games.size());
+    QTest::qWait(150);
+    painted.clear();
+
+    // Много ходов в угловых досках между кадрами - по одной перерисовке
+    // каждой, соседние доски не трогаются
+    games[0]->makeMove(0, 0);
+    games[0]->makeMove(1, 1);
+    games[0]->makeMove(2, 2);
+    games[15]->makeMove(0, 2);
+    games[15]->newGame();
+    games[15]->makeMove(1, 0);
+
+    QTRY_COMPARE(painted.count(), 2);
+    QTest::qWait(150);
+    QCOMPARE(painted.count(), 2);
+
+    QSet<int> boards;
+    for (const QList<QVariant> &arguments : painted) {
+        boards.insert(arguments.at(0).toInt());
+    }
+    QCOMPARE(boards, QSet<int>({ 0, 15 }));
+}
+
+void TestSpectatorGrid::testPoolResultsInTitle()
+{
+    GameEngine::Config config;
+    config.maxDepth = 2;
+    config.timeLimitMs = 0;
+    config.hashSizeMb = 1;
+
+    SpectatorGrid grid;
+    SelfPlayPool pool(config, 2);
+    connect(&pool, &SelfPlayPool::gameFinished, &grid, &SpectatorGrid::addResult);
+    QSignalSpy finished(&pool, &SelfPlayPool::gameFinished);
+
+    for (int i = 0; i < 4; ++i) {
+        GameLogic *logic = new GameLogic(&pool);
+        grid.addGame(logic);
+        pool.addGame(logic);
+    }
+
+    QTRY_VERIFY_WITH_TIMEOUT(finished.count() >= 4, 10000);
+
+    // X, O и ничьи в заголовке в сумме дают число сыгранных партий
+    QRegularExpression pattern("X (\\d+)  O (\\d+)  ничьи (\\d+)");
+    QRegularExpressionMatch match = pattern.match(grid.windowTitle());
+    QVERIFY(match.hasMatch());
+    QCOMPARE(match.captured(1).toInt() + match.captured(2).toInt() + match.captured(3).toInt(),
+             finished.count());
+}
+
+QTEST_MAIN(TestSpectatorGrid)
+#include "test_spectatorgrid.moc"
@@ -0,0 +1,117 @@
+#include <QtTest>
+#include "tournament.h"
+
+class TestTournament : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testEloFromScore();
+    void testEloError();
+    void testLlr();
+    void testRandomOpening();
+    void testRun();
+};
+
+void TestTournament::testEloFromScore()
+{
+    QCOMPARE(MatchStats::eloFromScore(0.5), 0.0);
+    QVERIFY(qAbs(MatchStats::eloFromScore(0.75) - 190.85) < 0.01);
+    QVERIFY(qAbs(MatchStats::scoreFromElo(MatchStats::eloFromScore(0.3)) - 0.3) < 1e-9);
+
+    MatchStats stats;
+    stats.wins = 30;
+    stats.draws = 40;
+    stats.losses = 30;
+    QCOMPARE(stats.games(), 100);
+    QCOMPARE(stats.score(), 0.5);
+    QCOMPARE(stats.elo(), 0.0);
+}
+
+void TestTournament::testEloError()
+{
+    MatchStats small;
+    small.wins = 6;
+    small.draws = 8;
+    small.losses = 6;
+
+    MatchStats large;
+    large.wins = 600;
+    large.draws = 800;
+    large.losses = 600;
+
+    QVERIFY(small.eloError() > 0.0);
+    QVERIFY(large.eloError() < small.eloError());
+
+    // Серия ничьих не даёт нулевой погрешности
+    MatchStats draws;
+    draws.draws = 20;
+    QVERIFY(draws.eloError() > 0.0);
+}
+
+void TestTournament::testLlr()
+{
+    MatchStats stronger;
+    stronger.wins = 300;
+    stronger.draws = 400;
+    stronger.losses = 200;
+    QVERIFY(stronger.llr(0.0, 10.0) > 0.0);
+
+    MatchStats weaker;
+    weaker.wins = 200;
+    weaker.draws = 400;
+    weaker.losses = 300;
+    QVERIFY(weaker.llr(0.0, 10.0) < 0.0);
+
+    MatchStats draws;
+    draws.draws = 200;
+    QVERIFY(draws.llr(0.0, 10.0) < 0.0);
+}
+
+void TestTournament::testRandomOpening()
+{
+    Position first = Tournament::randomOpening(5, 2, 42);
+    Position second = Tournament::randomOpening(5, 2, 42);
+
+    QCOMPARE(first.moveCount(), 2);
+    QCOMPARE(first.hash(), second.hash());
+    QVERIFY(!first.isFinished());
+}
+
+void TestTournament::testRun()
+{
+    GameEngine::Config strong;
+    strong.maxDepth = 9;
+    strong.timeLimitMs = 0;
+    strong.hashSizeMb = 1;
+
+    GameEngine::Config weak = strong;
+    weak.maxDepth = 1;
+
+    Tournament::Settings settings;
+    settings.boardSizes = { 3 };
+    settings.maxGames = 16;
+    settings.threads = 2;
+    settings.openingPlies = 2;
+    settings.sprt = false;
+
+    Tournament::Result result = Tournament(strong, weak, settings).run();
+    QCOMPARE(result.stats.games(), 16);
+    QCOMPARE(result.outcome, Tournament::OutcomeMaxGames);
+    // Проигрыши возможны только из проигранных дебютов - их получают оба
+    QVERIFY(result.stats.wins > result.stats.losses);
+
+    // Партии детерминированы, поэтому при перестановке движков счёт
+    // зеркален - результаты приписываются движку, а не цвету
+    Tournament::Result swapped = Tournament(weak, strong, settings).run();
+    QCOMPARE(swapped.stats.wins, result.stats.losses);
+    QCOMPARE(swapped.stats.draws, result.stats.draws);
+    QCOMPARE(swapped.stats.losses, result.stats.wins);
+
+    // Нечётное число партий не округляется вверх
+    settings.maxGames = 5;
+    QCOMPARE(Tournament(strong, weak, settings).run().stats.games(), 5);
+}
+
+QTEST_APPLESS_MAIN(TestTournament)
+#include "test_tournament.moc"
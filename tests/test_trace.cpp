@@ -0,0 +1,118 @@
+#include <QtTest>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QTemporaryDir>
+#include <atomic>
+#include <thread>
+#include "trace.h"
+
+class TestTrace : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testShortLivedThreads();
+};
+
+void TestTrace::testShortLivedThreads()
+{
+    Trace::start();
+
+    // Потоки по одному, как у анализа на каждый ход
+    for (int i = 0; i < 5; ++i) {
+        std::thread([]() {
+            Trace::setThreadName("worker");
+            TRACE_SCOPE("job", "test");
+        }).join();
+    }
+    // Первое событие до setThreadName
+    for (int i = 0; i < 3; ++i) {
+        std::thread([]() {
+            Trace::instant("early", "test");
+            Trace::setThreadName("late");
+            TRACE_SCOPE("job", "test");
+        }).join();
+    }
+    // Безымянные потоки
+    for (int i = 0; i < 3; ++i) {
+        std::thread([]() {
+            TRACE_SCOPE("job", "test");
+        }).join();
+    }
+    // По два одновременных потока с одним именем
+    for (int i = 0; i < 3; ++i) {
+        std::atomic<int> started(0);
+        auto body = [&started]() {
+            Trace::setThreadName("pool");
+            // Оба потока живы одновременно
+            started.fetch_add(1);
+            while (started.load() < 2) {
+                std::this_thread::yield();
+            }
+            for (int j = 0; j < 10; ++j) {
+                TRACE_SCOPE("job", "test");
+            }
+        };
+        std::thread first(body);
+        std::thread second(body);
+        first.join();
+        second.join();
+    }
+
+    Trace::stop();
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("trace.json");
+    QVERIFY(Trace::writeChromeTrace(path.toStdString()));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QVERIFY(document.object().value("traceEvents").isArray());
+
+    QHash<QString, int> rows;
+    QHash<int, QString> names;
+    int jobs = 0;
+    QSet<int> earlyTids;
+    QSet<int> tids;
+    for (const QJsonValue &value : document.object().value("traceEvents").toArray()) {
+        QJsonObject event = value.toObject();
+        int tid = event.value("tid").toInt();
+        if (event.value("ph").toString() == "M") {
+            QString name = event.value("args").toObject().value("name").toString();
+            ++rows[name];
+            names[tid] = name;
+            continue;
+        }
+        tids.insert(tid);
+        if (event.value("name").toString() == "job") {
+            QCOMPARE(event.value("ph").toString(), QString("X"));
+            ++jobs;
+        } else if (event.value("name").toString() == "early") {
+            earlyTids.insert(tid);
+        }
+    }
+
+    // Одна строка на имя, две - на два одновременных потока
+    QCOMPARE(rows.value("worker"), 1);
+    QCOMPARE(rows.value("late"), 1);
+    QCOMPARE(rows.value("pool"), 2);
+
+    // Ранние события остаются в одной безымянной строке, её же берут
+    // безымянные потоки
+    QCOMPARE(earlyTids.size(), 1);
+    QVERIFY(!names.contains(*earlyTids.begin()));
+    QCOMPARE(tids.size(), 5);
+
+    // Ни одно событие не потеряно
+    QCOMPARE(jobs, 5 + 3 + 3 + 3 * 2 * 10);
+}
+
+QTEST_MAIN(TestTrace)
+#include "test_trace.moc"
@@ -0,0 +1,113 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <fstream>
+#include "enginespec.h"
+#include "openingbook.h"
+#include "tournament.h"
+#include "trace.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("bookbuilder");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Построение дебютной книги по записанным партиям и самоигре");
+    parser.addHelpOption();
+    parser.addPositionalArgument("games", "Файлы с записями партий.", "[games...]");
+    parser.addOptions({
+        { { "o", "output" }, "Файл книги.", "file", "book.bin" },
+        { "self-play", "Сыграть дополнительно столько партий.", "n", "0" },
+        { "engine", "Движок для самоигры.", "spec", "name=book,depth=6,time=100" },
+        { "sizes", "Размеры поля для самоигры.", "list", "3,4,5,6,7,8,9,10" },
+        { "threads", "Число потоков (0 - по числу ядер).", "n", "0" },
+        { "plies", "Глубина книги в полуходах.", "n", "6" },
+        { "min-games", "Минимум партий для записи в книгу.", "n", "4" },
+        { "record", "Дописывать партии самоигры в файл.", "file" },
+        { "trace", "Записать трассировку в формате Chrome Trace Event.", "file" },
+    });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QString tracePath = parser.value("trace");
+    if (!tracePath.isEmpty()) {
+        Trace::start();
+        Trace::setThreadName("main");
+    }
+
+    BookBuilder builder(parser.value("plies").toInt());
+
+    const QStringList files = parser.positionalArguments();
+    for (const QString &path : files) {
+        std::ifstream in(path.toStdString());
+        if (!in) {
+            err << QString("Не удалось открыть %1").arg(path) << Qt::endl;
+            return 1;
+        }
+
+        GameRecord record;
+        while (readGameRecord(in, record)) {
+            builder.addGame(record);
+        }
+    }
+
+    int selfPlay = parser.value("self-play").toInt();
+    if (selfPlay > 0) {
+        GameEngine::Config config;
+        Tournament::Settings settings;
+        QString error;
+        if (!parseEngineSpec(parser.value("engine"), config, error)
+            || !parseBoardSizes(parser.value("sizes"), settings.boardSizes, error)) {
+            err << error << Qt::endl;
+            return 1;
+        }
+        settings.maxGames = selfPlay;
+        settings.threads = parser.value("threads").toInt();
+        settings.sprt = false;
+
+        std::ofstream record;
+        if (parser.isSet("record")) {
+            record.open(parser.value("record").toStdString(), std::ios::app);
+            if (!record.is_open()) {
+                err << QString("Не удалось открыть %1").arg(parser.value("record")) << Qt::endl;
+                return 1;
+            }
+        }
+
+        // Разнообразие партий дают случайные дебютные ходы турнира
+        Tournament tournament(config, config, settings);
+        tournament.setGameCallback([&builder, &record](const GameRecord &game) {
+            builder.addGame(game);
+            if (record.is_open()) writeGameRecord(record, game);
+        });
+        tournament.run([&out](const Tournament::Result &progress) {
+            out << QString("\rСамоигра: %1 партий").arg(progress.stats.games());
+            out.flush();
+        });
+        out << Qt::endl;
+    }
+
+    std::vector<OpeningBook::Entry> entries = builder.entries(parser.value("min-games").toInt());
+    const QString output = parser.value("output");
+    if (!OpeningBook::write(output.toStdString(), entries)) {
+        err << QString("Не удалось записать %1").arg(output) << Qt::endl;
+        return 1;
+    }
+    out << QString("Партий: %1, записей в книге: %2 -> %3")
+               .arg(qulonglong(builder.gameCount()))
+               .arg(qulonglong(entries.size()))
+               .arg(output)
+        << Qt::endl;
+
+    if (!tracePath.isEmpty()) {
+        Trace::stop();
+        if (!Trace::writeChromeTrace(tracePath.toStdString())) {
+            err << QString("Не удалось записать %1").arg(tracePath) << Qt::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef ENGINESPEC_H
+#define ENGINESPEC_H
+
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include "gameengine.h"
+
+// Описание движка: "name=d4,depth=4,time=100,nodes=0,hash=16"
+inline bool parseEngineSpec(const QString &spec, GameEngine::Config &config, QString &error)
+{
+    const QStringList fields = spec.split(',', Qt::SkipEmptyParts);
+    for (const QString &field : fields) {
+        QString key = field.section('=', 0, 0).trimmed();
+        QString value = field.section('=', 1).trimmed();
+        bool ok = true;
+
+        if (key == "name") {
+            config.name = value.toStdString();
+        } else if (key == "depth") {
+            config.maxDepth = value.toInt(&ok);
+        } else if (key == "time") {
+            config.timeLimitMs = value.toInt(&ok);
+        } else if (key == "nodes") {
+            config.nodeLimit = value.toULongLong(&ok);
+        } else if (key == "hash") {
+            config.hashSizeMb = value.toInt(&ok);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            error = QString("Некорректный параметр движка: %1").arg(field);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Размеры поля через запятую: "3,4,5"
+inline bool parseBoardSizes(const QString &list, std::vector<int> &sizes, QString &error)
+{
+    sizes.clear();
+    const QStringList fields = list.split(',', Qt::SkipEmptyParts);
+    for (const QString &field : fields) {
+        int size = field.toInt();
+        if (size < Position::MinSize || size > Position::MaxSize) {
+            error = QString("Некорректный размер поля: %1").arg(field);
+            return false;
+        }
+        sizes.push_back(size);
+    }
+    return true;
+}
+
+#endif // ENGINESPEC_H
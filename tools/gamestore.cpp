@@ -0,0 +1,178 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <fstream>
+#include "gamestore.h"
+#include "trace.h"
+
+namespace {
+
+QString percent(std::uint64_t part, std::uint64_t total)
+{
+    return QString::number(total > 0 ? 100.0 * double(part) / double(total) : 0.0, 'f', 1) + "%";
+}
+
+QString outcomesText(const GameStore::Outcomes &outcomes)
+{
+    return QString("%1 партий  X %2  ничьи %3  O %4")
+        .arg(qulonglong(outcomes.games), 10)
+        .arg(percent(outcomes.xWins, outcomes.games), 6)
+        .arg(percent(outcomes.draws, outcomes.games), 6)
+        .arg(percent(outcomes.oWins, outcomes.games), 6);
+}
+
+QString cellText(int cell, int size)
+{
+    return QString("(%1,%2)").arg(cell / size + 1).arg(cell % size + 1);
+}
+
+int build(const QString &directory, const QStringList &files, int dictionaryPlies, QTextStream &out,
+          QTextStream &err)
+{
+    GameStoreWriter writer(directory.toStdString(), dictionaryPlies);
+    if (!writer.isOpen()) {
+        err << QString("Не удалось создать %1").arg(directory) << Qt::endl;
+        return 1;
+    }
+
+    std::uint64_t skipped = 0;
+    for (const QString &path : files) {
+        std::ifstream in(path.toStdString());
+        if (!in) {
+            err << QString("Не удалось открыть %1").arg(path) << Qt::endl;
+            return 1;
+        }
+
+        GameRecord record;
+        while (readGameRecord(in, record)) {
+            if (!writer.add(record)) ++skipped;
+        }
+    }
+
+    if (!writer.finish()) {
+        err << QString("Не удалось записать %1").arg(directory) << Qt::endl;
+        return 1;
+    }
+    out << QString("Партий: %1, ходов: %2, позиций в словаре: %3, пропущено: %4")
+               .arg(qulonglong(writer.gameCount())).arg(qulonglong(writer.moveCount()))
+               .arg(qulonglong(writer.positionCount())).arg(qulonglong(skipped))
+        << Qt::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("gamestore");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Колоночное хранилище партий и запросы к нему.\n"
+        "  build <store> <games...>   собрать хранилище из записей партий\n"
+        "  openings <store>           результаты по первому ходу (--size)\n"
+        "  lengths <store>            результаты и длина партий по размерам поля\n"
+        "  position <store>           продолжения позиции (--size, --moves)");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "build, openings, lengths или position.");
+    parser.addPositionalArgument("store", "Каталог хранилища.");
+    parser.addOptions({
+        { "size", "Размер поля.", "n", "3" },
+        { "moves", "Ходы до позиции через запятую (индексы клеток).", "list", "" },
+        { "dictionary-plies", "Сколько первых полуходов кодировать в словаре.", "n", "8" },
+        { "threads", "Число потоков (0 - по числу ядер).", "n", "0" },
+        { "trace", "Записать трассировку в формате Chrome Trace Event.", "file" },
+    });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() < 2) {
+        parser.showHelp(1);
+    }
+    const QString command = arguments[0];
+    const QString directory = arguments[1];
+
+    const QString tracePath = parser.value("trace");
+    if (!tracePath.isEmpty()) {
+        Trace::start();
+        Trace::setThreadName("main");
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int status = 0;
+
+    if (command == "build") {
+        status = build(directory, arguments.mid(2), parser.value("dictionary-plies").toInt(), out, err);
+    } else {
+        GameStore store(directory.toStdString());
+        if (!store.isOpen()) {
+            err << QString("Не удалось открыть хранилище %1").arg(directory) << Qt::endl;
+            return 1;
+        }
+        store.setThreads(parser.value("threads").toInt());
+        int size = parser.value("size").toInt();
+
+        if (command == "openings") {
+            for (const GameStore::MoveStats &stats : store.openings(size)) {
+                out << cellText(stats.cell, size) << "  " << outcomesText(stats.outcomes) << Qt::endl;
+            }
+        } else if (command == "lengths") {
+            for (const GameStore::SizeStats &stats : store.sizeStats(parser.isSet("size") ? size : 0)) {
+                out << QString("%1x%1  ").arg(stats.size) << outcomesText(stats.outcomes) << Qt::endl;
+                for (std::size_t length = 0; length < stats.lengths.size(); ++length) {
+                    if (stats.lengths[length] == 0) continue;
+                    out << QString("    %1 ходов: %2 (%3)").arg(length, 3)
+                               .arg(qulonglong(stats.lengths[length]))
+                               .arg(percent(stats.lengths[length], stats.outcomes.games))
+                        << Qt::endl;
+                }
+            }
+        } else if (command == "position") {
+            if (size < Position::MinSize || size > Position::MaxSize) {
+                err << QString("Некорректный размер поля %1").arg(size) << Qt::endl;
+                return 1;
+            }
+
+            Position position(size);
+            const QStringList moves = parser.value("moves").split(',', Qt::SkipEmptyParts);
+            for (const QString &text : moves) {
+                bool ok = false;
+                int move = text.trimmed().toInt(&ok);
+                if (!ok || move < 0 || move >= position.cellCount() || position.cell(move) != 0
+                    || position.winner() != 0 || position.isFull()) {
+                    err << QString("Некорректный ход %1").arg(text) << Qt::endl;
+                    return 1;
+                }
+                position.play(move);
+            }
+
+            for (const GameStore::MoveStats &stats : store.continuations(position)) {
+                out << cellText(stats.cell, size) << "  " << outcomesText(stats.outcomes) << Qt::endl;
+            }
+        } else {
+            err << QString("Неизвестная команда %1").arg(command) << Qt::endl;
+            return 1;
+        }
+
+        out << QString("В хранилище %1 партий, %2 ходов")
+                   .arg(qulonglong(store.gameCount())).arg(qulonglong(store.moveCount()))
+            << Qt::endl;
+    }
+
+    out << QString("Время: %1 мс").arg(timer.elapsed()) << Qt::endl;
+
+    if (!tracePath.isEmpty()) {
+        Trace::stop();
+        if (!Trace::writeChromeTrace(tracePath.toStdString())) {
+            err << QString("Не удалось записать %1").arg(tracePath) << Qt::endl;
+            return 1;
+        }
+    }
+    return status;
+}
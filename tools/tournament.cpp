@@ -0,0 +1,130 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <fstream>
+#include <memory>
+#include <QStringList>
+#include <QTextStream>
+#include "enginespec.h"
+#include "openingbook.h"
+#include "tournament.h"
+#include "trace.h"
+
+namespace {
+
+QString outcomeText(Tournament::Outcome outcome)
+{
+    switch (outcome) {
+    case Tournament::OutcomeAcceptH0: return "H0 принята (улучшения нет)";
+    case Tournament::OutcomeAcceptH1: return "H1 принята (улучшение)";
+    case Tournament::OutcomeMaxGames: return "достигнут лимит партий";
+    default: return "прервано";
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("tournament");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Матч двух конфигураций движка с оценкой Elo и SPRT");
+    parser.addHelpOption();
+    parser.addOptions({
+        { "first", "Тестируемый движок.", "spec", "name=new,depth=6,time=50" },
+        { "second", "Базовый движок.", "spec", "name=base,depth=4,time=50" },
+        { "games", "Максимальное число партий.", "n", "1000" },
+        { "sizes", "Размеры поля через запятую.", "list", "3,4,5" },
+        { "threads", "Число потоков (0 - по числу ядер).", "n", "0" },
+        { "opening-plies", "Случайных ходов в дебюте (-1 - авто).", "n", "-1" },
+        { "seed", "Зерно генератора дебютов.", "n", "1" },
+        { "elo0", "Elo гипотезы H0.", "elo", "0" },
+        { "elo1", "Elo гипотезы H1.", "elo", "10" },
+        { "alpha", "Вероятность ошибки первого рода.", "p", "0.05" },
+        { "beta", "Вероятность ошибки второго рода.", "p", "0.05" },
+        { "no-sprt", "Играть все партии без ранней остановки." },
+        { "book", "Дебютная книга для обоих движков.", "file" },
+        { "record", "Дописывать сыгранные партии в файл.", "file" },
+        { "trace", "Записать трассировку в формате Chrome Trace Event.", "file" },
+    });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    GameEngine::Config first;
+    GameEngine::Config second;
+    QString error;
+    if (!parseEngineSpec(parser.value("first"), first, error)
+        || !parseEngineSpec(parser.value("second"), second, error)) {
+        err << error << Qt::endl;
+        return 1;
+    }
+
+    Tournament::Settings settings;
+    if (!parseBoardSizes(parser.value("sizes"), settings.boardSizes, error)) {
+        err << error << Qt::endl;
+        return 1;
+    }
+    settings.maxGames = parser.value("games").toInt();
+    settings.threads = parser.value("threads").toInt();
+    settings.openingPlies = parser.value("opening-plies").toInt();
+    settings.seed = parser.value("seed").toULongLong();
+    settings.elo0 = parser.value("elo0").toDouble();
+    settings.elo1 = parser.value("elo1").toDouble();
+    settings.alpha = parser.value("alpha").toDouble();
+    settings.beta = parser.value("beta").toDouble();
+    settings.sprt = !parser.isSet("no-sprt");
+
+    const QString tracePath = parser.value("trace");
+    if (!tracePath.isEmpty()) {
+        Trace::start();
+        Trace::setThreadName("main");
+    }
+
+    Tournament tournament(first, second, settings);
+
+    std::unique_ptr<OpeningBook> book;
+    if (parser.isSet("book")) {
+        book.reset(new OpeningBook(parser.value("book").toStdString()));
+        tournament.setBook(book.get());
+    }
+
+    std::ofstream record;
+    if (parser.isSet("record")) {
+        record.open(parser.value("record").toStdString(), std::ios::app);
+        if (!record) {
+            err << QString("Не удалось открыть %1").arg(parser.value("record")) << Qt::endl;
+            return 1;
+        }
+        tournament.setGameCallback([&record](const GameRecord &game) {
+            writeGameRecord(record, game);
+        });
+    }
+    out << QString("%1 vs %2, SPRT [%3, %4], LLR границы [%5, %6]")
+               .arg(QString::fromStdString(first.name), QString::fromStdString(second.name))
+               .arg(settings.elo0).arg(settings.elo1)
+               .arg(tournament.lowerBound(), 0, 'f', 2).arg(tournament.upperBound(), 0, 'f', 2)
+        << Qt::endl;
+
+    Tournament::Result result = tournament.run([&out](const Tournament::Result &progress) {
+        const MatchStats &stats = progress.stats;
+        out << QString("\rПартий: %1  +%2 =%3 -%4  Elo: %5 +/- %6  LLR: %7")
+                   .arg(stats.games()).arg(stats.wins).arg(stats.draws).arg(stats.losses)
+                   .arg(stats.elo(), 0, 'f', 1).arg(stats.eloError(), 0, 'f', 1)
+                   .arg(progress.llr, 0, 'f', 2);
+        out.flush();
+    });
+
+    out << Qt::endl << "Итог: " << outcomeText(result.outcome) << Qt::endl;
+
+    if (!tracePath.isEmpty()) {
+        Trace::stop();
+        if (!Trace::writeChromeTrace(tracePath.toStdString())) {
+            err << QString("Не удалось записать %1").arg(tracePath) << Qt::endl;
+            return 1;
+        }
+    }
+    return 0;
+}